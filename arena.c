@@ -0,0 +1,87 @@
+#include <string.h>
+#include <sys/mman.h>
+
+#include "arena.h"
+
+size_t ArenaAllocSize(size_t size)
+{
+    return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+bool CreateArena(arena *scratch, size_t capacity)
+{
+    *scratch = (arena){0};
+    capacity = ArenaAllocSize(capacity > 0 ? capacity : 1);
+    // Reserved without swap behind it, the pages are filled in when they are first written
+    void *base = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (base == MAP_FAILED)
+    {
+        return false;
+    }
+    scratch->base = base;
+    scratch->capacity = capacity;
+    return true;
+}
+
+void FreeArena(arena *scratch)
+{
+    if (scratch->base != NULL)
+    {
+        munmap(scratch->base, scratch->capacity);
+    }
+    *scratch = (arena){0};
+}
+
+size_t ArenaMark(const arena *scratch)
+{
+    return scratch->used;
+}
+
+void ArenaRelease(arena *scratch, size_t mark)
+{
+    scratch->used = mark;
+    scratch->last = mark;
+}
+
+bool ReserveArena(arena *scratch, size_t capacity)
+{
+    if (scratch->base != NULL && scratch->capacity >= capacity)
+    {
+        ArenaRelease(scratch, 0);
+        return true;
+    }
+    FreeArena(scratch);
+    return CreateArena(scratch, capacity);
+}
+
+void *ArenaAlloc(arena *scratch, size_t size)
+{
+    size = ArenaAllocSize(size);
+    if (size > scratch->capacity - scratch->used)
+    {
+        return NULL;
+    }
+    scratch->last = scratch->used;
+    scratch->used += size;
+    return scratch->base + scratch->last;
+}
+
+void *ArenaGrow(arena *scratch, void *memory, size_t oldSize, size_t newSize)
+{
+    if (memory != NULL && (unsigned char *)memory == scratch->base + scratch->last)
+    {
+        newSize = ArenaAllocSize(newSize);
+        if (newSize > scratch->capacity - scratch->last)
+        {
+            return NULL;
+        }
+        scratch->used = scratch->last + newSize;
+        return memory;
+    }
+    void *grown = ArenaAlloc(scratch, newSize);
+    if (grown != NULL && memory != NULL)
+    {
+        memcpy(grown, memory, oldSize < newSize ? oldSize : newSize);
+    }
+    return grown;
+}
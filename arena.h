@@ -0,0 +1,37 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Every allocation starts on a multiple of this
+#define ARENA_ALIGN 16
+
+// Working memory handed out from one reservation by bumping an offset. Nothing is freed on its own, everything after
+// a mark is released at once by going back to it. The pages are only backed by memory once they are touched, so a
+// generous reservation costs address space and not memory, and an arena that is used again keeps its pages
+typedef struct arena
+{
+    unsigned char *base;
+    size_t capacity;
+    size_t used;
+    // Where the last allocation starts so it can grow in place
+    size_t last;
+} arena;
+
+bool CreateArena(arena *scratch, size_t capacity);
+void FreeArena(arena *scratch);
+// Makes sure the arena can hold capacity bytes and empties it, the reservation is only replaced when it is too small
+bool ReserveArena(arena *scratch, size_t capacity);
+// NULL if the reservation is used up
+void *ArenaAlloc(arena *scratch, size_t size);
+// Grows an allocation, in place if it is the last one, otherwise it is copied to a new one
+void *ArenaGrow(arena *scratch, void *memory, size_t oldSize, size_t newSize);
+
+// The bytes an allocation of size takes from the arena, padding included
+size_t ArenaAllocSize(size_t size);
+size_t ArenaMark(const arena *scratch);
+// Releases everything allocated since the mark
+void ArenaRelease(arena *scratch, size_t mark);
+
+#endif
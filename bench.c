@@ -0,0 +1,2103 @@
+// Headless benchmark for the terrain generator, doesn't open a window so it can run without a display
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "raylib.h"
+#include "raymath.h"
+
+#include "generator.h"
+#include "rng.h"
+#include "classify.h"
+#include "render.h"
+#include "stream.h"
+#include "snapshot.h"
+#include "profiler.h"
+#include "sim.h"
+#include "farm.h"
+#include "hexquery.h"
+
+#define MAX_SWEEP 16
+
+typedef struct sweep
+{
+    int values[MAX_SWEEP];
+    int count;
+} sweep;
+
+// Parses a comma separated list like "51,101,201"
+static bool ParseSweep(const char *text, sweep *out)
+{
+    out->count = 0;
+    while (*text != '\0' && out->count < MAX_SWEEP)
+    {
+        char *end;
+        long value = strtol(text, &end, 10);
+        if (end == text)
+        {
+            return false;
+        }
+        out->values[out->count++] = (int)value;
+        text = *end == ',' ? end + 1 : end;
+    }
+    return out->count > 0;
+}
+
+static void PrintUsage(const char *name)
+{
+    printf("usage: %s [generate] [--seeds n] [--seed first] [--radius list] [--ants list] [--turn list] [--room list] [--threads list] [--log level] [--format csv|json]\n", name);
+    printf("       %s render [--frames n] [--radius list] [--vision n]\n", name);
+    printf("       %s raster [--seed n] [--radius n] [--frames n] [--size WxH] [--vision n] [--golden checksum] [--capture file]\n", name);
+    printf("       %s stream [--seed n] [--distance n]\n", name);
+    printf("       %s replay --input file [--ticks n] [--seed n] [--distance n]\n", name);
+    printf("       %s snapshot [--seed n] [--radius list] [--out file]\n", name);
+    printf("       %s access [--steps n] [--radius list]\n", name);
+    printf("       %s tune [--seed n] [--distance n] [--room list]\n", name);
+    printf("       %s classify [--passes n] [--radius list]\n", name);
+    printf("       %s swarm [--ants list] [--radius n] [--seed n]\n", name);
+    printf("       %s query [--radius list] [--tiles n]\n", name);
+    printf("       %s arena [--seeds n] [--radius list] [--ants list]\n", name);
+    printf("       %s farm [--seeds n] [--seed first] [--radius n] [--workers list] [--out file]\n", name);
+    printf("lists are comma separated, e.g. --radius 51,101,201\n");
+}
+
+// FNV-1a over every tile of the generated region, to check that different settings produce the same map
+static uint32_t HashRegion(hexMap *map, int mapRadius)
+{
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < mapRadius; i++)
+    {
+        for (int j = 0; j < mapRadius; j++)
+        {
+            hash = (hash ^ (uint32_t)GetTile(map, IndexToHexCoord(i, j))) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+// Generates the map for every seed with the parameters and prints one CSV row averaged over the seeds, or with json
+// one JSON object per seed. Returns false if generation failed
+static bool BenchGenerateParams(hexMap *map, arena *scratch, generatorParams params, uint64_t firstSeed, int seeds, bool json)
+{
+    double phaseTime[GENERATORPHASE_COUNT] = {0};
+    double total = 0;
+    long long stepsWalked = 0;
+    long long wallBounces = 0;
+    long long collisions = 0;
+    long long tilesTouched = 0;
+    long long rooms = 0;
+    long long networks = 0;
+    long long roomTiles = 0;
+    double roomTime = 0;
+    long long corridorTiles = 0;
+    long long floorTiles = 0;
+    long long reachableTiles = 0;
+    uint32_t mapHash = 0;
+    // The flood fill runs after the phases so it doesn't show up in their times
+    params.validate = true;
+    for (int seed = 0; seed < seeds; seed++)
+    {
+        generatorStats stats;
+        params.seed = firstSeed + seed;
+        ClearMap(map);
+        if (!GenerateMapInArena(map, scratch, params, &stats))
+        {
+            fprintf(stderr, "failed to generate a map with mapRadius %d\n", params.mapRadius);
+            return false;
+        }
+        for (int p = 0; p < GENERATORPHASE_COUNT; p++)
+        {
+            phaseTime[p] += stats.phaseTime[p];
+            total += stats.phaseTime[p];
+        }
+        stepsWalked += stats.stepsWalked;
+        wallBounces += stats.wallBounces;
+        collisions += stats.collisions;
+        tilesTouched += stats.tilesTouched;
+        rooms += stats.rooms;
+        networks += stats.networks;
+        roomTiles += stats.roomTiles;
+        roomTime += stats.roomTime;
+        corridorTiles += stats.corridorTiles;
+        floorTiles += stats.floorTiles;
+        reachableTiles += stats.reachableTiles;
+        mapHash = mapHash * 31 + HashRegion(map, params.mapRadius);
+        if (json)
+        {
+            WriteGeneratorStats(stdout, params, &stats, STATSFORMAT_JSON, false);
+        }
+    }
+    if (json)
+    {
+        fflush(stdout);
+        return true;
+    }
+
+    // Everything is averaged over the seeds
+    printf("%d,%d,%d,%d,%d,%d", params.mapRadius, params.antCount,
+        params.turnChanceDenominator, params.roomRadius, params.threads, seeds);
+    for (int p = 0; p < GENERATORPHASE_COUNT; p++)
+    {
+        printf(",%.3f", phaseTime[p] * 1000 / seeds);
+    }
+    // Carving time per room tile stays flat if carving scales with rooms * roomRadius^2 and not the map area
+    printf(",%.3f,%lld,%lld,%lld,%lld,%.1f,%.1f,%lld,%.3f,%.1f,%lld,%.4f,%08x\n", total * 1000 / seeds,
+        stepsWalked / seeds, wallBounces / seeds, collisions / seeds, tilesTouched / seeds,
+        (double)rooms / seeds, (double)networks / seeds, roomTiles / seeds,
+        roomTime * 1000 / seeds, roomTiles > 0 ? roomTime * 1e9 / roomTiles : 0.0,
+        corridorTiles / seeds, floorTiles > 0 ? (double)reachableTiles / floorTiles : 0.0, mapHash);
+    fflush(stdout);
+    return true;
+}
+
+static int BenchGenerate(int argc, char **argv)
+{
+    generatorParams defaults = DefaultGeneratorParams();
+    int seeds = 10;
+    uint64_t firstSeed = 1;
+    sweep radii = {{defaults.mapRadius}, 1};
+    sweep antCounts = {{defaults.antCount}, 1};
+    sweep turnChances = {{defaults.turnChanceDenominator}, 1};
+    sweep roomRadii = {{defaults.roomRadius}, 1};
+    sweep threadCounts = {{defaults.threads}, 1};
+    bool json = false;
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--seeds") == 0)
+        {
+            seeds = atoi(argv[++i]);
+            ok = seeds > 0;
+        }
+        else if (ok && strcmp(argv[i], "--seed") == 0)
+        {
+            firstSeed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (ok && strcmp(argv[i], "--radius") == 0)
+        {
+            ok = ParseSweep(argv[++i], &radii);
+        }
+        else if (ok && strcmp(argv[i], "--ants") == 0)
+        {
+            ok = ParseSweep(argv[++i], &antCounts);
+        }
+        else if (ok && strcmp(argv[i], "--turn") == 0)
+        {
+            ok = ParseSweep(argv[++i], &turnChances);
+        }
+        else if (ok && strcmp(argv[i], "--room") == 0)
+        {
+            ok = ParseSweep(argv[++i], &roomRadii);
+        }
+        else if (ok && strcmp(argv[i], "--threads") == 0)
+        {
+            ok = ParseSweep(argv[++i], &threadCounts);
+        }
+        else if (ok && strcmp(argv[i], "--log") == 0)
+        {
+            ok = ParseGeneratorLogLevel(argv[++i], &defaults.logLevel);
+        }
+        else if (ok && strcmp(argv[i], "--format") == 0)
+        {
+            i++;
+            json = strcmp(argv[i], "json") == 0;
+            ok = json || strcmp(argv[i], "csv") == 0;
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return -1;
+        }
+    }
+
+    // CSV so the results can be compared between runs on CI
+    if (!json)
+    {
+        printf("mapRadius,antCount,turnChanceDenominator,roomRadius,threads,seeds");
+        for (int p = 0; p < GENERATORPHASE_COUNT; p++)
+        {
+            printf(",%sMs", generatorPhaseNames[p]);
+        }
+        printf(",totalMs,stepsWalked,wallBounces,collisions,tilesTouched,rooms,networks,roomTiles,carveMs,carveNsPerRoomTile,corridorTiles,reachable,mapHash\n");
+    }
+
+    hexMap map = {0};
+    // One arena for every map, it is only reserved again when a map needs more
+    arena scratch = {0};
+    int combinations = radii.count * antCounts.count * turnChances.count * roomRadii.count * threadCounts.count;
+    for (int c = 0; c < combinations; c++)
+    {
+        // The thread count changes fastest so the scaling rows for the same map end up next to each other
+        int k = c;
+        generatorParams params = defaults;
+        params.threads = threadCounts.values[k % threadCounts.count];
+        k /= threadCounts.count;
+        params.roomRadius = roomRadii.values[k % roomRadii.count];
+        k /= roomRadii.count;
+        params.turnChanceDenominator = turnChances.values[k % turnChances.count];
+        k /= turnChances.count;
+        params.antCount = antCounts.values[k % antCounts.count];
+        k /= antCounts.count;
+        params.mapRadius = radii.values[k];
+
+        if (!GeneratorParamsValid(params))
+        {
+            fprintf(stderr, "skipping mapRadius %d, antCount %d, turn %d, roomRadius %d, threads %d\n",
+                params.mapRadius, params.antCount, params.turnChanceDenominator, params.roomRadius, params.threads);
+            continue;
+        }
+
+        if (!BenchGenerateParams(&map, &scratch, params, firstSeed, seeds, json))
+        {
+            ClearMap(&map);
+            FreeArena(&scratch);
+            return 1;
+        }
+    }
+
+    ClearMap(&map);
+    FreeArena(&scratch);
+    return 0;
+}
+
+// The tile selection the render loop did before BuildVisibleTiles, three scans over the whole map
+static int SelectTilesByScan(hexMap *map, const renderView *view, hexCoord player, int visionRadius, int mapRadius)
+{
+    int selected = 0;
+    for (int pass = 0; pass < 3; pass++)
+    {
+        for (int i = 0; i < mapRadius; i++)
+        {
+            for (int j = 0; j < mapRadius; j++)
+            {
+                hexCoord b = IndexToHexCoord(i, j);
+                if (
+                    abs(player.q - b.q) < visionRadius &&
+                    abs(player.r - b.r) < visionRadius &&
+                    abs(player.s - b.s) < visionRadius &&
+                    abs(b.q) <= mapRadius / 2 &&
+                    abs(b.r) <= mapRadius / 2 &&
+                    abs(b.s) <= mapRadius / 2 &&
+                    (pass == 0 || GetTile(map, IndexToHexCoord(i, j)) == TILETYPE_WALL))
+                {
+                    Vector2 position = HexCoordToCameraVector(view, IndexToHexCoord(i, j));
+                    selected += position.x > -1e9f;
+                }
+            }
+        }
+    }
+    return selected;
+}
+
+// Compares the cost of picking the tiles to draw each frame, the old scan over the whole map against the field of view
+static int BenchRender(int argc, char **argv)
+{
+    int frames = 1000;
+    int visionRadius = 7;
+    sweep radii = {{51, 101, 201, 401}, 4};
+
+    for (int i = 0; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--frames") == 0)
+        {
+            frames = atoi(argv[++i]);
+            ok = frames > 0;
+        }
+        else if (ok && strcmp(argv[i], "--radius") == 0)
+        {
+            ok = ParseSweep(argv[++i], &radii);
+        }
+        else if (ok && strcmp(argv[i], "--vision") == 0)
+        {
+            visionRadius = atoi(argv[++i]);
+            ok = visionRadius > 0;
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return -1;
+        }
+    }
+
+    printf("mapRadius,visionRadius,frames,scanUsPerFrame,fovUsPerMove,cachedUsPerFrame,cacheHits,scanTiles,fovTiles\n");
+    hexMap map = {0};
+    renderView view;
+    InitRenderView(&view);
+    visibleTiles visible = {0};
+    fovCache fov;
+    if (!InitFovCache(&fov, visionRadius - 1))
+    {
+        return 1;
+    }
+    for (int a = 0; a < radii.count; a++)
+    {
+        generatorParams params = DefaultGeneratorParams();
+        params.mapRadius = radii.values[a];
+        int mapRadius = params.mapRadius;
+        ClearMap(&map);
+        if (params.mapRadius / 2 - ANT_EDGE_MARGIN < 1 || !GenerateMap(&map, params, NULL))
+        {
+            fprintf(stderr, "skipping mapRadius %d\n", params.mapRadius);
+            continue;
+        }
+
+        // The player walks back and forth along a line through the centre so the work varies like it would in game
+        int reach = mapRadius / 2 - visionRadius;
+        hexCoord player = (hexCoord){0, 0, 0};
+        int scanTiles = 0;
+        double start = GetTimeSeconds();
+        for (int f = 0; f < frames; f++)
+        {
+            player.q = reach > 0 ? f % (reach * 2) - reach : 0;
+            player.s = -player.q;
+            scanTiles = SelectTilesByScan(&map, &view, player, visionRadius, mapRadius);
+        }
+        double scanTime = GetTimeSeconds() - start;
+
+        // Casting the field of view every frame, what it costs each time the player moves to a new tile
+        int fovTiles = 0;
+        start = GetTimeSeconds();
+        for (int f = 0; f < frames; f++)
+        {
+            player.q = reach > 0 ? f % (reach * 2) - reach : 0;
+            player.s = -player.q;
+            MarkMapChanged(&map);
+            BuildVisibleTiles(&view, &visible, GetFieldOfView(&fov, &map, player));
+            fovTiles = visible.count + visible.wallCount * 2;
+        }
+        double fovTime = GetTimeSeconds() - start;
+
+        // What the game does, the player stays on a tile for several frames and walks back over the same tiles
+        fov.hits = 0;
+        start = GetTimeSeconds();
+        for (int f = 0; f < frames; f++)
+        {
+            int move = f / 8;
+            player.q = reach > 0 ? move % (reach * 2) - reach : 0;
+            player.s = -player.q;
+            BuildVisibleTiles(&view, &visible, GetFieldOfView(&fov, &map, player));
+        }
+        double cachedTime = GetTimeSeconds() - start;
+
+        printf("%d,%d,%d,%.2f,%.2f,%.2f,%lld,%d,%d\n", mapRadius, visionRadius, frames,
+            scanTime * 1e6 / frames, fovTime * 1e6 / frames, cachedTime * 1e6 / frames, fov.hits, scanTiles, fovTiles);
+        fflush(stdout);
+    }
+    FreeFovCache(&fov);
+    FreeVisibleTiles(&visible);
+    ClearMap(&map);
+    return 0;
+}
+
+// Time until the spawn chunk and then every chunk around it have been generated in the background,
+// compared with generating all of them before the first frame
+// The game's frame drawn into a framebuffer in memory while a scripted player walks around a generated map, the
+// same seed always draws the same frames so their checksum can be compared against a golden value
+static int BenchRaster(int argc, char **argv)
+{
+    uint64_t seed = 1;
+    int mapRadius = 201;
+    int frames = 600;
+    int width = 1280;
+    int height = 720;
+    int visionRadius = 7;
+    const char *golden = NULL;
+    const char *capturePath = NULL;
+    for (int i = 0; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--seed") == 0)
+        {
+            seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (ok && strcmp(argv[i], "--radius") == 0)
+        {
+            mapRadius = atoi(argv[++i]);
+        }
+        else if (ok && strcmp(argv[i], "--frames") == 0)
+        {
+            frames = atoi(argv[++i]);
+            ok = frames > 0;
+        }
+        else if (ok && strcmp(argv[i], "--size") == 0)
+        {
+            ok = sscanf(argv[++i], "%dx%d", &width, &height) == 2 && width > 0 && height > 0;
+        }
+        else if (ok && strcmp(argv[i], "--vision") == 0)
+        {
+            visionRadius = atoi(argv[++i]);
+            ok = visionRadius > 0;
+        }
+        else if (ok && strcmp(argv[i], "--golden") == 0)
+        {
+            golden = argv[++i];
+        }
+        else if (ok && strcmp(argv[i], "--capture") == 0)
+        {
+            capturePath = argv[++i];
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return -1;
+        }
+    }
+
+    generatorParams params = DefaultGeneratorParams();
+    params.mapRadius = mapRadius;
+    params.seed = seed;
+    hexMap map = {0};
+    if (params.mapRadius % 2 == 0 || params.mapRadius / 2 - ANT_EDGE_MARGIN < 1 || !GenerateMap(&map, params, NULL))
+    {
+        fprintf(stderr, "failed to generate a map with mapRadius %d\n", mapRadius);
+        ClearMap(&map);
+        return 1;
+    }
+
+    framebuffer target;
+    fovCache fov;
+    frameProfiler profiler;
+    if (!CreateFramebuffer(&target, width, height))
+    {
+        return 1;
+    }
+    if (!InitFovCache(&fov, visionRadius - 1))
+    {
+        FreeFramebuffer(&target);
+        return 1;
+    }
+    if (!InitFrameProfiler(&profiler, frames))
+    {
+        FreeFovCache(&fov);
+        FreeFramebuffer(&target);
+        return 1;
+    }
+    visibleTiles visible = {0};
+    // The tile size and the frame rate are fixed so the frames don't depend on the machine
+    renderView view;
+    InitRenderView(&view);
+    view.tileRadius = 80;
+    view.target = &target;
+    float frameTime = 1.0f / 60;
+    Vector2 centre = {width / 2, height / 2};
+
+    // The player mostly walks straight and turns now and then or when a wall is in the way, like the ants do
+    hexCoord player = {0, 0, 0};
+    hexCoord oldPlayer = player;
+    int direction = 0;
+    int moves = 0;
+    float moveLerp = 1;
+    uint32_t checksum = 2166136261u;
+    for (int f = 0; f < frames; f++)
+    {
+        BeginProfiledFrame(&profiler);
+        if (moveLerp >= 1)
+        {
+            uint64_t bits = RandomBits(seed, RANDOMSTREAM_PATH, 0, moves++);
+            int turn = RandomRange(bits, 0, 3) == 0 ? RandomRange(bits << 32, 1, 5) : 0;
+            for (int k = 0; k < 6; k++)
+            {
+                int d = (direction + turn + k) % 6;
+                if (IsWalkable(&map, HexCoordAdd(player, directionToCoords[d])))
+                {
+                    direction = d;
+                    oldPlayer = player;
+                    player = HexCoordAdd(player, directionToCoords[d]);
+                    moveLerp = 0;
+                    break;
+                }
+            }
+        }
+        EndFrameSection(&profiler, FRAMESECTION_INPUT);
+
+        // The same camera as the game
+        if (moveLerp < 1)
+        {
+            moveLerp += frameTime * 5;
+        }
+        moveLerp = moveLerp < 1 ? moveLerp : 1;
+        view.cameraPos = Vector2Lerp(
+            Vector2Add(Vector2Scale(HexCoordToVector(&view, oldPlayer), -1), centre),
+            Vector2Add(Vector2Scale(HexCoordToVector(&view, player), -1), centre),
+            moveLerp);
+        EndFrameSection(&profiler, FRAMESECTION_CAMERA);
+
+        BuildVisibleTiles(&view, &visible, GetFieldOfView(&fov, &map, player));
+        EndFrameSection(&profiler, FRAMESECTION_FOV);
+
+        view.stats = (renderCounters){0};
+        ClearFramebuffer(&target, BLACK);
+        DrawFloorTiles(&view, &visible);
+        DrawPlayer(&view, Vector2Lerp(HexCoordToCameraVector(&view, oldPlayer), HexCoordToCameraVector(&view, player), moveLerp));
+        EndFrameSection(&profiler, FRAMESECTION_FLOOR);
+        DrawWallSides(&view, &visible);
+        EndFrameSection(&profiler, FRAMESECTION_WALLSIDES);
+        DrawWallTops(&view, &visible);
+        EndFrameSection(&profiler, FRAMESECTION_WALLTOPS);
+
+        profiler.current.tilesConsidered = fov.lastTilesCast;
+        profiler.current.tilesDrawn = view.stats.tiles;
+        profiler.current.triangles = view.stats.triangles;
+        profiler.current.drawCalls = view.stats.drawCalls;
+        EndProfiledFrame(&profiler);
+        // Outside the timed frame
+        checksum = (checksum ^ FramebufferChecksum(&target)) * 16777619u;
+    }
+
+    frameSummary summary = SummarizeFrames(&profiler);
+    char checksumText[16];
+    snprintf(checksumText, sizeof(checksumText), "%08x", checksum);
+    bool match = golden == NULL || strcmp(golden, checksumText) == 0;
+    printf("mapRadius,width,height,frames,moves,minMs,avgMs,p99Ms,fovMs,floorMs,wallSidesMs,wallTopsMs,tilesDrawn,triangles,checksum,golden\n");
+    printf("%d,%d,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.0f,%.0f,%s,%s\n", mapRadius, width, height, frames, moves,
+        summary.minTime * 1000, summary.averageTime * 1000, summary.p99Time * 1000,
+        summary.sectionAverage[FRAMESECTION_FOV] * 1000, summary.sectionAverage[FRAMESECTION_FLOOR] * 1000,
+        summary.sectionAverage[FRAMESECTION_WALLSIDES] * 1000, summary.sectionAverage[FRAMESECTION_WALLTOPS] * 1000,
+        summary.tilesDrawn, summary.triangles, checksumText, golden == NULL ? "-" : match ? "ok" : "FAILED");
+    if (capturePath != NULL && !WriteFrameCapture(&profiler, capturePath))
+    {
+        fprintf(stderr, "failed to write %s\n", capturePath);
+        match = false;
+    }
+
+    FreeVisibleTiles(&visible);
+    FreeFrameProfiler(&profiler);
+    FreeFovCache(&fov);
+    FreeFramebuffer(&target);
+    ClearMap(&map);
+    return match ? 0 : 1;
+}
+
+// Runs the ticks of a recording with the chunks around the player generated as it walks, returns false if the
+// file can't be read. The chunks are generated right away instead of on the streamer's thread so every run is the same
+static bool ReplayHeadless(hexMap *map, const char *path, int distance, gameState *game, double *generateTime, bool *match)
+{
+    inputReplay replay;
+    if (!OpenReplay(&replay, path))
+    {
+        return false;
+    }
+    generatorParams params = ReplayParams(&replay, DefaultChunkParams());
+    ClearMap(map);
+    InitGameState(game);
+    *generateTime = 0;
+    tickInput input;
+    while (NextReplayInput(&replay, &input))
+    {
+        double start = GetTimeSeconds();
+        GenerateChunksAround(map, game->player, distance, params);
+        *generateTime += GetTimeSeconds() - start;
+        StepGame(game, map, input);
+    }
+    *match = ReplayMatches(&replay, game);
+    CloseReplay(&replay);
+    return true;
+}
+
+// Replays a recording from the game headless as fast as it runs, or records a scripted player for --ticks first
+static int BenchReplay(int argc, char **argv)
+{
+    const char *path = NULL;
+    long long ticks = 0;
+    uint64_t seed = 1;
+    int distance = 1;
+    for (int i = 0; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--input") == 0)
+        {
+            path = argv[++i];
+        }
+        else if (ok && strcmp(argv[i], "--ticks") == 0)
+        {
+            ticks = atoll(argv[++i]);
+            ok = ticks > 0;
+        }
+        else if (ok && strcmp(argv[i], "--seed") == 0)
+        {
+            seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (ok && strcmp(argv[i], "--distance") == 0)
+        {
+            distance = atoi(argv[++i]);
+            ok = distance >= 0;
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return -1;
+        }
+    }
+    if (path == NULL)
+    {
+        return -1;
+    }
+
+    // The scripted player holds one of the keys, or none, for up to two seconds at a time
+    hexMap map = {0};
+    double recordTime = 0;
+    if (ticks > 0)
+    {
+        generatorParams params = DefaultChunkParams();
+        params.seed = seed;
+        inputRecorder recorder;
+        if (!StartRecording(&recorder, path, params))
+        {
+            fprintf(stderr, "failed to write %s\n", path);
+            return 1;
+        }
+        ClearMap(&map);
+        gameState game;
+        InitGameState(&game);
+        double start = GetTimeSeconds();
+        tickInput input = 0;
+        long long runEnd = 0;
+        for (long long t = 0; t < ticks; t++)
+        {
+            if (t == runEnd)
+            {
+                uint64_t bits = RandomBits(seed, RANDOMSTREAM_PATH, 1, (uint32_t)t);
+                int key = RandomRange(bits, 0, 6);
+                input = key < 6 ? 1 << key : 0;
+                runEnd = t + RandomRange(bits << 32, 1, SIM_TICK_RATE * 2);
+            }
+            GenerateChunksAround(&map, game.player, distance, params);
+            RecordInput(&recorder, input);
+            StepGame(&game, &map, input);
+        }
+        recordTime = GetTimeSeconds() - start;
+        if (!StopRecording(&recorder, &game))
+        {
+            fprintf(stderr, "failed to write %s\n", path);
+            ClearMap(&map);
+            return 1;
+        }
+    }
+
+    gameState game;
+    double generateTime;
+    bool match;
+    double start = GetTimeSeconds();
+    if (!ReplayHeadless(&map, path, distance, &game, &generateTime, &match))
+    {
+        fprintf(stderr, "failed to read %s\n", path);
+        return 1;
+    }
+    double replayTime = GetTimeSeconds() - start;
+    FILE *file = fopen(path, "rb");
+    long fileBytes = -1;
+    if (file != NULL)
+    {
+        fseek(file, 0, SEEK_END);
+        fileBytes = ftell(file);
+        fclose(file);
+    }
+
+    // ticksPerSecond leaves out generating the chunks so it shows what the movement and the wall checks cost
+    printf("ticks,gameMinutes,moves,blockedMoves,chunks,fileBytes,recordMs,replayMs,generateMs,ticksPerSecond,q,r,match\n");
+    printf("%lld,%.1f,%lld,%lld,%d,%ld,%.1f,%.1f,%.1f,%.0f,%d,%d,%s\n", game.tick, game.tick / (60.0 * SIM_TICK_RATE),
+        game.moves, game.blockedMoves, MapChunkCount(&map), fileBytes, recordTime * 1000, replayTime * 1000,
+        generateTime * 1000, replayTime - generateTime > 0 ? game.tick / (replayTime - generateTime) : 0.0,
+        game.player.q, game.player.r, match ? "ok" : "FAILED");
+    ClearMap(&map);
+    return match ? 0 : 1;
+}
+
+static int BenchStream(int argc, char **argv)
+{
+    uint64_t seed = 1;
+    int distance = 1;
+    for (int i = 0; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--seed") == 0)
+        {
+            seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (ok && strcmp(argv[i], "--distance") == 0)
+        {
+            distance = atoi(argv[++i]);
+            ok = distance >= 0;
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return -1;
+        }
+    }
+
+    generatorParams params = DefaultChunkParams();
+    params.seed = seed;
+
+    hexMap map = {0};
+    double start = GetTimeSeconds();
+    GenerateChunksAround(&map, (hexCoord){0, 0, 0}, distance, params);
+    double blockingTime = GetTimeSeconds() - start;
+    ClearMap(&map);
+
+    chunkStreamer streamer;
+    if (!StartChunkStreamer(&streamer, &map, params))
+    {
+        fprintf(stderr, "failed to start the generator thread\n");
+        return 1;
+    }
+    start = GetTimeSeconds();
+    double spawnTime = -1;
+    int chunks = (distance * 2 + 1) * (distance * 2 + 1);
+    // Poll like the game loop does every frame
+    while (MapChunkCount(&map) < chunks)
+    {
+        StreamChunksAround(&streamer, (hexCoord){0, 0, 0}, distance);
+        if (spawnTime < 0 && GetChunk(&map, 0, 0) != NULL)
+        {
+            spawnTime = GetTimeSeconds() - start;
+        }
+        nanosleep(&(struct timespec){0, 100000}, NULL);
+    }
+    double allTime = GetTimeSeconds() - start;
+    StopChunkStreamer(&streamer);
+
+    printf("seed,distance,chunks,blockingMs,spawnChunkMs,allChunksMs\n");
+    printf("%llu,%d,%d,%.3f,%.3f,%.3f\n", (unsigned long long)seed, distance, chunks,
+        blockingTime * 1000, spawnTime * 1000, allTime * 1000);
+    ClearMap(&map);
+    return 0;
+}
+
+// FNV-1a over the tiles of the chunks within distance of chunk (0, 0)
+static uint32_t HashChunks(hexMap *map, int distance)
+{
+    uint32_t hash = 2166136261u;
+    for (int q = -distance; q <= distance; q++)
+    {
+        for (int r = -distance; r <= distance; r++)
+        {
+            mapChunk *chunk = GetChunk(map, q, r);
+            for (int i = 0; chunk != NULL && i < CHUNK_SIZE * CHUNK_SIZE; i++)
+            {
+                hash = (hash ^ chunk->tiles[i]) * 16777619u;
+            }
+        }
+    }
+    return hash;
+}
+
+// Changes the room radius of a world of chunks, by generating every chunk again and by carving the rooms again from
+// the kept trails, and checks that both give the same tiles
+static int BenchTune(int argc, char **argv)
+{
+    uint64_t seed = 1;
+    int distance = 3;
+    sweep roomRadii = {{2, 6, 10, 4}, 4};
+    for (int i = 0; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--seed") == 0)
+        {
+            seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (ok && strcmp(argv[i], "--distance") == 0)
+        {
+            distance = atoi(argv[++i]);
+            ok = distance >= 0;
+        }
+        else if (ok && strcmp(argv[i], "--room") == 0)
+        {
+            ok = ParseSweep(argv[++i], &roomRadii);
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return -1;
+        }
+    }
+
+    generatorParams params = DefaultChunkParams();
+    params.seed = seed;
+    params.keepTrails = true;
+    hexMap map = {0};
+    GenerateChunksAround(&map, (hexCoord){0, 0, 0}, distance, params);
+    int count = MapChunkCount(&map);
+    mapChunk **chunks = malloc(sizeof(mapChunk *) * (count + 1));
+    if (chunks == NULL)
+    {
+        ClearMap(&map);
+        return 1;
+    }
+
+    printf("distance,chunks,fromRoomRadius,toRoomRadius,regenerateMs,recarveMs,recarvedTiles,match\n");
+    for (int a = 0; a < roomRadii.count; a++)
+    {
+        int from = params.roomRadius;
+        params.roomRadius = roomRadii.values[a];
+        if (params.roomRadius < 1)
+        {
+            fprintf(stderr, "skipping roomRadius %d\n", params.roomRadius);
+            params.roomRadius = from;
+            continue;
+        }
+
+        // The kept world is moved out of the way while the reference is generated from scratch
+        CollectChunks(&map, chunks);
+        for (int i = 0; i < count; i++)
+        {
+            chunks[i]->owned = false;
+        }
+        ClearMap(&map);
+        generatorParams fresh = params;
+        fresh.keepTrails = false;
+        double start = GetTimeSeconds();
+        GenerateChunksAround(&map, (hexCoord){0, 0, 0}, distance, fresh);
+        double regenerateTime = GetTimeSeconds() - start;
+        uint32_t regeneratedHash = HashChunks(&map, distance);
+        ClearMap(&map);
+
+        long long tiles = 0;
+        start = GetTimeSeconds();
+        for (int i = 0; i < count; i++)
+        {
+            tiles += RecarveRooms(chunks[i], params.roomRadius);
+        }
+        double recarveTime = GetTimeSeconds() - start;
+        for (int i = 0; i < count; i++)
+        {
+            chunks[i]->owned = true;
+            InsertChunk(&map, chunks[i]);
+        }
+        bool match = HashChunks(&map, distance) == regeneratedHash;
+
+        printf("%d,%d,%d,%d,%.3f,%.3f,%lld,%s\n", distance, count, from, params.roomRadius,
+            regenerateTime * 1000, recarveTime * 1000, tiles, match ? "ok" : "FAILED");
+        fflush(stdout);
+        if (!match)
+        {
+            free(chunks);
+            ClearMap(&map);
+            return 1;
+        }
+    }
+    free(chunks);
+    ClearMap(&map);
+    return 0;
+}
+
+// Classification throughput on a trail buffer shaped like a generated one, the scalar loop against the vector one
+static int BenchClassify(int argc, char **argv)
+{
+    int passes = 10;
+    sweep radii = {{1001, 2001, 3001}, 3};
+    for (int i = 0; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--passes") == 0)
+        {
+            passes = atoi(argv[++i]);
+            ok = passes > 0;
+        }
+        else if (ok && strcmp(argv[i], "--radius") == 0)
+        {
+            ok = ParseSweep(argv[++i], &radii);
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return -1;
+        }
+    }
+
+    printf("mapRadius,tiles,backend,scalarMTilesPerSec,vectorMTilesPerSec,rooms,match\n");
+    for (int a = 0; a < radii.count; a++)
+    {
+        int mapRadius = radii.values[a];
+        long long tiles = (long long)mapRadius * mapRadius;
+        int *trails = malloc(sizeof(int) * tiles);
+        uint8_t *scalarTiles = malloc(tiles);
+        uint8_t *vectorTiles = malloc(tiles);
+        int *scalarRooms = malloc(sizeof(int) * mapRadius);
+        int *vectorRooms = malloc(sizeof(int) * mapRadius);
+        if (trails == NULL || scalarTiles == NULL || vectorTiles == NULL || scalarRooms == NULL || vectorRooms == NULL)
+        {
+            fprintf(stderr, "skipping mapRadius %d\n", mapRadius);
+            free(trails);
+            free(scalarTiles);
+            free(vectorTiles);
+            free(scalarRooms);
+            free(vectorRooms);
+            continue;
+        }
+
+        // About a tenth of a generated map is trails and there is a room for every few thousand tiles
+        for (long long i = 0; i < tiles; i++)
+        {
+            uint64_t bits = RandomBits(1, RANDOMSTREAM_PLACE, (uint32_t)(i >> 32), (uint32_t)i);
+            int roll = RandomRange(bits, 0, 9999);
+            trails[i] = roll < 9000 ? -1 : roll < 9998 ? (int)(bits & 1023) : -2 - (int)(bits & 1023);
+        }
+
+        // Row by row like the generator
+        bool match = true;
+        long long rooms = 0;
+        double start = GetTimeSeconds();
+        for (int p = 0; p < passes; p++)
+        {
+            for (int q = 0; q < mapRadius; q++)
+            {
+                ClassifyTrailsScalar(trails + (long long)q * mapRadius, scalarTiles + (long long)q * mapRadius, mapRadius, scalarRooms);
+            }
+        }
+        double scalarTime = GetTimeSeconds() - start;
+        start = GetTimeSeconds();
+        for (int p = 0; p < passes; p++)
+        {
+            for (int q = 0; q < mapRadius; q++)
+            {
+                ClassifyTrails(trails + (long long)q * mapRadius, vectorTiles + (long long)q * mapRadius, mapRadius, vectorRooms);
+            }
+        }
+        double vectorTime = GetTimeSeconds() - start;
+
+        // The rooms are checked outside the timing
+        for (int q = 0; q < mapRadius && match; q++)
+        {
+            int scalarFound = ClassifyTrailsScalar(trails + (long long)q * mapRadius, scalarTiles + (long long)q * mapRadius, mapRadius, scalarRooms);
+            int vectorFound = ClassifyTrails(trails + (long long)q * mapRadius, vectorTiles + (long long)q * mapRadius, mapRadius, vectorRooms);
+            match = scalarFound == vectorFound && memcmp(scalarRooms, vectorRooms, sizeof(int) * scalarFound) == 0;
+            rooms += scalarFound;
+        }
+        match = match && memcmp(scalarTiles, vectorTiles, tiles) == 0;
+
+        printf("%d,%lld,%s,%.1f,%.1f,%lld,%s\n", mapRadius, tiles, ClassifyBackend(),
+            tiles * passes / scalarTime * 1e-6, tiles * passes / vectorTime * 1e-6, rooms, match ? "ok" : "FAILED");
+        fflush(stdout);
+        free(trails);
+        free(scalarTiles);
+        free(vectorTiles);
+        free(scalarRooms);
+        free(vectorRooms);
+        if (!match)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Tile lookup the map did before CoordToChunk and TileIndex used shifts and masks, kept to compare against
+static TILETYPE GetTileByDivision(hexMap *map, hexCoord coord)
+{
+    int q = (coord.q + CHUNK_SIZE / 2) / CHUNK_SIZE - ((coord.q + CHUNK_SIZE / 2) % CHUNK_SIZE != 0 && coord.q + CHUNK_SIZE / 2 < 0);
+    int r = (coord.r + CHUNK_SIZE / 2) / CHUNK_SIZE - ((coord.r + CHUNK_SIZE / 2) % CHUNK_SIZE != 0 && coord.r + CHUNK_SIZE / 2 < 0);
+    mapChunk *chunk = GetChunk(map, q, r);
+    if (chunk == NULL)
+    {
+        return TILETYPE_NONE;
+    }
+    return (TILETYPE)chunk->tiles[(coord.q + CHUNK_SIZE / 2 - q * CHUNK_SIZE) * CHUNK_SIZE + coord.r + CHUNK_SIZE / 2 - r * CHUNK_SIZE];
+}
+
+// Walks an ant around a trail buffer, addressing the tiles the way the generator used to, with the interleaved index
+static long long WalkInterleaved(int *cells, int mapRadius, const unsigned char *directions, int steps)
+{
+    int limit = mapRadius / 2 - 1;
+    hexCoord position = (hexCoord){0, 0, 0};
+    long long sum = 0;
+    for (int k = 0; k < steps; k++)
+    {
+        hexCoord next = HexCoordAdd(position, directionToCoords[directions[k & 0xffff]]);
+        if (abs(next.q) <= limit && abs(next.r) <= limit && abs(next.s) <= limit)
+        {
+            position = next;
+        }
+        sum += cells[(abs(position.q * 2) - (position.q > 0)) * mapRadius + abs(position.r * 2) - (position.r > 0)]++;
+    }
+    return sum;
+}
+
+// The same walk with the row-major layout, the slot is moved by the neighbour offset like the generator does now
+static long long WalkOffsets(int *cells, int mapRadius, const unsigned char *directions, int steps)
+{
+    int limit = mapRadius / 2 - 1;
+    int *centre = cells + (mapRadius / 2) * mapRadius + mapRadius / 2;
+    int offsets[6];
+    for (int d = 0; d < 6; d++)
+    {
+        offsets[d] = directionToCoords[d].q * mapRadius + directionToCoords[d].r;
+    }
+    hexCoord position = (hexCoord){0, 0, 0};
+    int slot = 0;
+    long long sum = 0;
+    for (int k = 0; k < steps; k++)
+    {
+        int direction = directions[k & 0xffff];
+        hexCoord next = HexCoordAdd(position, directionToCoords[direction]);
+        if (abs(next.q) <= limit && abs(next.r) <= limit && abs(next.s) <= limit)
+        {
+            position = next;
+            slot += offsets[direction];
+        }
+        sum += centre[slot]++;
+    }
+    return sum;
+}
+
+// Tile access throughput, the trail buffer with the old and new layouts and GetTile with the old and new lookups
+static int BenchAccess(int argc, char **argv)
+{
+    int steps = 20000000;
+    sweep radii = {{101, 401, 1001, 2001}, 4};
+    for (int i = 0; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--steps") == 0)
+        {
+            steps = atoi(argv[++i]);
+            ok = steps > 0;
+        }
+        else if (ok && strcmp(argv[i], "--radius") == 0)
+        {
+            ok = ParseSweep(argv[++i], &radii);
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return -1;
+        }
+    }
+
+    unsigned char directions[0x10000];
+    for (int k = 0; k < 0x10000; k++)
+    {
+        directions[k] = (unsigned char)RandomRange(RandomBits(1, RANDOMSTREAM_STEP, 0, k), 0, 5);
+    }
+
+    printf("mapRadius,steps,interleavedNsPerStep,offsetNsPerStep,tiles,divisionMTilesPerSec,maskMTilesPerSec\n");
+    hexMap map = {0};
+    for (int a = 0; a < radii.count; a++)
+    {
+        generatorParams params = DefaultGeneratorParams();
+        params.mapRadius = radii.values[a];
+        int mapRadius = params.mapRadius;
+        int half = mapRadius / 2;
+        int *cells = calloc((size_t)mapRadius * mapRadius, sizeof(int));
+        ClearMap(&map);
+        if (cells == NULL || mapRadius % 2 == 0 || half - ANT_EDGE_MARGIN < 1 || !GenerateMap(&map, params, NULL))
+        {
+            fprintf(stderr, "skipping mapRadius %d\n", mapRadius);
+            free(cells);
+            continue;
+        }
+
+        double start = GetTimeSeconds();
+        long long interleavedSum = WalkInterleaved(cells, mapRadius, directions, steps);
+        double interleavedTime = GetTimeSeconds() - start;
+        memset(cells, 0, sizeof(int) * mapRadius * mapRadius);
+        start = GetTimeSeconds();
+        long long offsetSum = WalkOffsets(cells, mapRadius, directions, steps);
+        double offsetTime = GetTimeSeconds() - start;
+        free(cells);
+        if (interleavedSum != offsetSum)
+        {
+            fprintf(stderr, "the walks visited different tiles\n");
+            ClearMap(&map);
+            return 1;
+        }
+
+        // Every lookup goes through the whole map once per pass, enough passes for about steps lookups.
+        // Both are called through a pointer so neither gets inlined into the loop and only the lookup differs
+        TILETYPE (*volatile lookups[2])(hexMap *, hexCoord) = {GetTileByDivision, GetTile};
+        double lookupTime[2];
+        int floors[2] = {0, 0};
+        long long tiles = 0;
+        int passes = (int)(steps / ((long long)mapRadius * mapRadius)) + 1;
+        for (int l = 0; l < 2; l++)
+        {
+            TILETYPE (*lookup)(hexMap *, hexCoord) = lookups[l];
+            tiles = 0;
+            start = GetTimeSeconds();
+            for (int p = 0; p < passes; p++)
+            {
+                for (int q = -half; q <= half; q++)
+                {
+                    for (int r = -half; r <= half; r++)
+                    {
+                        floors[l] += lookup(&map, (hexCoord){q, r, -q - r}) == TILETYPE_FLOOR;
+                        tiles++;
+                    }
+                }
+            }
+            lookupTime[l] = GetTimeSeconds() - start;
+        }
+        if (floors[0] != floors[1])
+        {
+            fprintf(stderr, "the lookups read different tiles\n");
+            ClearMap(&map);
+            return 1;
+        }
+
+        printf("%d,%d,%.2f,%.2f,%lld,%.1f,%.1f\n", mapRadius, steps,
+            interleavedTime * 1e9 / steps, offsetTime * 1e9 / steps, tiles,
+            tiles / lookupTime[0] * 1e-6, tiles / lookupTime[1] * 1e-6);
+        fflush(stdout);
+    }
+    ClearMap(&map);
+    return 0;
+}
+
+// Writes a generated map to a snapshot, loads it back and checks every tile, then compares the load time with the
+// time it took to generate the map
+static int BenchSnapshot(int argc, char **argv)
+{
+    uint64_t seed = 1;
+    const char *path = "bench_snapshot.bin";
+    sweep radii = {{101, 401, 1001, 2001}, 4};
+    for (int i = 0; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--seed") == 0)
+        {
+            seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (ok && strcmp(argv[i], "--radius") == 0)
+        {
+            ok = ParseSweep(argv[++i], &radii);
+        }
+        else if (ok && strcmp(argv[i], "--out") == 0)
+        {
+            path = argv[++i];
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return -1;
+        }
+    }
+
+    printf("mapRadius,chunks,fileKB,generateMs,saveMs,loadMs,loadAndReadMs,roundTrip\n");
+    hexMap map = {0};
+    for (int a = 0; a < radii.count; a++)
+    {
+        generatorParams params = DefaultGeneratorParams();
+        params.mapRadius = radii.values[a];
+        params.seed = seed;
+        if (params.mapRadius % 2 == 0 || params.mapRadius / 2 - ANT_EDGE_MARGIN < 1)
+        {
+            fprintf(stderr, "skipping mapRadius %d\n", params.mapRadius);
+            continue;
+        }
+
+        ClearMap(&map);
+        double start = GetTimeSeconds();
+        if (!GenerateMap(&map, params, NULL))
+        {
+            fprintf(stderr, "failed to generate a map with mapRadius %d\n", params.mapRadius);
+            return 1;
+        }
+        double generateTime = GetTimeSeconds() - start;
+        uint32_t generatedHash = HashRegion(&map, params.mapRadius);
+        int chunks = MapChunkCount(&map);
+
+        start = GetTimeSeconds();
+        if (!SaveSnapshot(&map, path, params))
+        {
+            fprintf(stderr, "failed to write %s\n", path);
+            return 1;
+        }
+        double saveTime = GetTimeSeconds() - start;
+        ClearMap(&map);
+
+        // Mapping is lazy so reading every tile afterwards shows what the page faults cost
+        snapshot loaded;
+        start = GetTimeSeconds();
+        if (!LoadSnapshot(&map, path, &loaded))
+        {
+            fprintf(stderr, "failed to load %s\n", path);
+            return 1;
+        }
+        double loadTime = GetTimeSeconds() - start;
+        uint32_t loadedHash = HashRegion(&map, params.mapRadius);
+        double readTime = GetTimeSeconds() - start;
+
+        bool roundTrip = loadedHash == generatedHash &&
+            MapChunkCount(&map) == chunks &&
+            loaded.header->seed == params.seed &&
+            loaded.header->mapRadius == params.mapRadius;
+        printf("%d,%d,%zu,%.3f,%.3f,%.3f,%.3f,%s\n", params.mapRadius, chunks, loaded.size / 1024,
+            generateTime * 1000, saveTime * 1000, loadTime * 1000, readTime * 1000, roundTrip ? "ok" : "FAILED");
+        fflush(stdout);
+        ClearMap(&map);
+        CloseSnapshot(&loaded);
+        if (!roundTrip)
+        {
+            remove(path);
+            return 1;
+        }
+    }
+    remove(path);
+    return 0;
+}
+
+// The ants the way the first pass kept them before, a struct per ant and every ant looked at on every step
+typedef struct scannedAnt
+{
+    hexCoord position;
+    int direction;
+    bool alive;
+    int steps;
+} scannedAnt;
+
+static hexCoord PlaceSwarmAnt(uint64_t seed, int i, int mapRadius, int *direction)
+{
+    int a = mapRadius / 2 - ANT_EDGE_MARGIN;
+    int q = RandomRange(RandomBits(seed, RANDOMSTREAM_PLACE, i, 0), -a, a);
+    int r = RandomRange(RandomBits(seed, RANDOMSTREAM_PLACE, i, 1), -a - (q * (q < 0)), a - (q * (q > 0)));
+    *direction = RandomRange(RandomBits(seed, RANDOMSTREAM_PLACE, i, 2), 0, 5);
+    return (hexCoord){q, r, -q - r};
+}
+
+static int TurnSwarmAnt(uint64_t seed, int i, int step, int direction)
+{
+    uint64_t bits = RandomBits(seed, RANDOMSTREAM_STEP, i, step);
+    if (RandomRange(bits, 0, 3) == 0)
+    {
+        direction += (bits & 1) == 0 ? -1 : 1;
+    }
+    return (direction + 6) % 6;
+}
+
+static bool SwarmAntInside(int q, int r, int s, int half)
+{
+    return abs(q) <= half - 1 && abs(r) <= half - 1 && abs(s) <= half - 1;
+}
+
+// A single threaded first pass over a trail buffer where an ant dies on the first tile another ant has been on,
+// with every ant checked for being alive on every step. Returns the steps walked, visited counts the ants looked at
+static long long WalkScannedAnts(int *cells, int mapRadius, int antCount, uint64_t seed, long long *visited)
+{
+    scannedAnt *ants = malloc(sizeof(scannedAnt) * antCount);
+    if (ants == NULL)
+    {
+        return -1;
+    }
+    int half = mapRadius / 2;
+    int *centre = cells + half * mapRadius + half;
+    for (int i = 0; i < antCount; i++)
+    {
+        int direction;
+        ants[i] = (scannedAnt){PlaceSwarmAnt(seed, i, mapRadius, &direction), direction, true, 0};
+    }
+
+    long long steps = 0;
+    *visited = 0;
+    for (int alive = antCount; alive > 0;)
+    {
+        alive = 0;
+        for (int i = 0; i < antCount; i++)
+        {
+            (*visited)++;
+            scannedAnt *a = &ants[i];
+            if (!a->alive)
+            {
+                continue;
+            }
+            a->direction = TurnSwarmAnt(seed, i, a->steps++, a->direction);
+            hexCoord next = HexCoordAdd(a->position, directionToCoords[a->direction]);
+            if (SwarmAntInside(next.q, next.r, next.s, half))
+            {
+                a->position = next;
+            }
+            else
+            {
+                a->direction = (a->direction + 3) % 6;
+            }
+            steps++;
+            int *tile = &centre[a->position.q * mapRadius + a->position.r];
+            if (*tile != -1 && *tile != i)
+            {
+                // Marked as a room like the generator does, so the ant whose trail it was dies there too
+                *tile = -2 - i;
+                a->alive = false;
+                continue;
+            }
+            *tile = i;
+            alive++;
+        }
+    }
+    free(ants);
+    return steps;
+}
+
+// The same walk with the ants in an array per field and a list of the live ones that is compacted as it is walked,
+// like the generator does now
+static long long WalkActiveAnts(int *cells, int mapRadius, int antCount, uint64_t seed, long long *visited)
+{
+    int *q = malloc(sizeof(int) * antCount);
+    int *r = malloc(sizeof(int) * antCount);
+    int *s = malloc(sizeof(int) * antCount);
+    uint8_t *directions = malloc(antCount);
+    int *antSteps = malloc(sizeof(int) * antCount);
+    int *active = malloc(sizeof(int) * antCount);
+    long long steps = -1;
+    if (q != NULL && r != NULL && s != NULL && directions != NULL && antSteps != NULL && active != NULL)
+    {
+        int half = mapRadius / 2;
+        int *centre = cells + half * mapRadius + half;
+        for (int i = 0; i < antCount; i++)
+        {
+            int direction;
+            hexCoord position = PlaceSwarmAnt(seed, i, mapRadius, &direction);
+            q[i] = position.q;
+            r[i] = position.r;
+            s[i] = position.s;
+            directions[i] = (uint8_t)direction;
+            antSteps[i] = 0;
+            active[i] = i;
+        }
+
+        steps = 0;
+        *visited = 0;
+        for (int activeCount = antCount; activeCount > 0;)
+        {
+            *visited += activeCount;
+            int kept = 0;
+            for (int k = 0; k < activeCount; k++)
+            {
+                int i = active[k];
+                int direction = TurnSwarmAnt(seed, i, antSteps[i]++, directions[i]);
+                hexCoord move = directionToCoords[direction];
+                if (SwarmAntInside(q[i] + move.q, r[i] + move.r, s[i] + move.s, half))
+                {
+                    q[i] += move.q;
+                    r[i] += move.r;
+                    s[i] += move.s;
+                }
+                else
+                {
+                    direction = (direction + 3) % 6;
+                }
+                directions[i] = (uint8_t)direction;
+                steps++;
+                int *tile = &centre[q[i] * mapRadius + r[i]];
+                if (*tile != -1 && *tile != i)
+                {
+                    *tile = -2 - i;
+                    continue;
+                }
+                *tile = i;
+                active[kept++] = i;
+            }
+            activeCount = kept;
+        }
+    }
+    free(q);
+    free(r);
+    free(s);
+    free(directions);
+    free(antSteps);
+    free(active);
+    return steps;
+}
+
+// The first pass with every ant scanned on every step against only the live ones, with a single threaded model of
+// the pass so both layouts run the same ants, and the time of the generator's own first pass next to them
+static int BenchSwarm(int argc, char **argv)
+{
+    sweep antCounts = {{10000, 100000, 1000000}, 3};
+    int mapRadius = 2001;
+    uint64_t seed = 1;
+    for (int i = 0; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--ants") == 0)
+        {
+            ok = ParseSweep(argv[++i], &antCounts);
+        }
+        else if (ok && strcmp(argv[i], "--radius") == 0)
+        {
+            mapRadius = atoi(argv[++i]);
+            ok = mapRadius % 2 == 1 && mapRadius / 2 - ANT_EDGE_MARGIN >= 1;
+        }
+        else if (ok && strcmp(argv[i], "--seed") == 0)
+        {
+            seed = strtoull(argv[++i], NULL, 10);
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return -1;
+        }
+    }
+
+    int *scanned = malloc(sizeof(int) * mapRadius * mapRadius);
+    int *compacted = malloc(sizeof(int) * mapRadius * mapRadius);
+    if (scanned == NULL || compacted == NULL)
+    {
+        free(scanned);
+        free(compacted);
+        return 1;
+    }
+    printf("mapRadius,antCount,steps,scanNsPerStep,activeNsPerStep,scannedPerStep,deadSkippedPerStep,firstPassMs,match\n");
+    hexMap map = {0};
+    arena scratch = {0};
+    int result = 0;
+    for (int a = 0; a < antCounts.count; a++)
+    {
+        int antCount = antCounts.values[a];
+        if (antCount < 2)
+        {
+            fprintf(stderr, "skipping antCount %d\n", antCount);
+            continue;
+        }
+        memset(scanned, 0xff, sizeof(int) * mapRadius * mapRadius);
+        memset(compacted, 0xff, sizeof(int) * mapRadius * mapRadius);
+        long long scanVisited = 0;
+        long long activeVisited = 0;
+        double start = GetTimeSeconds();
+        long long scanSteps = WalkScannedAnts(scanned, mapRadius, antCount, seed, &scanVisited);
+        double scanTime = GetTimeSeconds() - start;
+        start = GetTimeSeconds();
+        long long activeSteps = WalkActiveAnts(compacted, mapRadius, antCount, seed, &activeVisited);
+        double activeTime = GetTimeSeconds() - start;
+
+        generatorParams params = DefaultGeneratorParams();
+        params.mapRadius = mapRadius;
+        params.antCount = antCount;
+        params.seed = seed;
+        generatorStats stats;
+        ClearMap(&map);
+        bool generated = GenerateMapInArena(&map, &scratch, params, &stats);
+
+        // The models have to walk the same ants as the generator's first pass, it keeps its trails to itself but has to
+        // take as many steps, claim as many tiles and have every ant die
+        long long claimed = 0;
+        for (int i = 0; i < mapRadius * mapRadius; i++)
+        {
+            claimed += scanned[i] != -1;
+        }
+        bool match = scanSteps > 0 && scanSteps == activeSteps &&
+            memcmp(scanned, compacted, sizeof(int) * mapRadius * mapRadius) == 0 && generated &&
+            stats.stepsWalked == scanSteps && stats.tilesTouched == claimed && stats.collisions == antCount;
+        // The dead ants the scan looks at that the list of live ants skips
+        printf("%d,%d,%lld,%.2f,%.2f,%.2f,%.2f,%.3f,%s\n", mapRadius, antCount, scanSteps,
+            scanTime * 1e9 / scanSteps, activeTime * 1e9 / activeSteps,
+            (double)scanVisited / scanSteps, (double)(scanVisited - activeVisited) / scanSteps,
+            generated ? stats.phaseTime[GENERATORPHASE_FIRSTPASS] * 1000 : -1.0, match ? "ok" : "FAILED");
+        fflush(stdout);
+        if (!match || !generated)
+        {
+            result = 1;
+            break;
+        }
+    }
+    ClearMap(&map);
+    FreeArena(&scratch);
+    free(scanned);
+    free(compacted);
+    return result;
+}
+
+// The queue and seen flags of the flood fill, kept between queries like the generator keeps its arena
+typedef struct queryBuffers
+{
+    hexCoord *queue;
+    uint8_t *seen;
+} queryBuffers;
+
+// Added up over the tiles a query visits, so a query that visits the wrong tiles or one twice and another not at all
+// gives another sum than the reference
+static inline uint64_t QueryTileHash(hexCoord coord)
+{
+    uint64_t h = (uint32_t)coord.q * 0x9E3779B97F4A7C15ull ^ (uint32_t)coord.r * 0xC2B2AE3D27D4EB4Full;
+    return h ^ h >> 29;
+}
+
+// Every query returns the tiles it visited, the hashes of the coordinates are added up so the loops can't be optimised
+// out and the tiles can be checked. They all take the buffers so they fit in one table but only the flood fill uses them
+static int QueryRing(hexCoord centre, int radius, const queryBuffers *buffers, uint64_t *sum)
+{
+    (void)buffers;
+    int tiles = 0;
+    hexRing ring;
+    StartRing(&ring, centre, radius);
+    for (hexCoord coord; NextRingTile(&ring, &coord); tiles++)
+    {
+        *sum += QueryTileHash(coord);
+    }
+    return tiles;
+}
+
+static int QuerySpiral(hexCoord centre, int radius, const queryBuffers *buffers, uint64_t *sum)
+{
+    (void)buffers;
+    int tiles = 0;
+    hexSpiral spiral;
+    StartSpiral(&spiral, centre, radius);
+    for (hexCoord coord; NextSpiralTile(&spiral, &coord); tiles++)
+    {
+        *sum += QueryTileHash(coord);
+    }
+    return tiles;
+}
+
+static int QueryDisc(hexCoord centre, int radius, const queryBuffers *buffers, uint64_t *sum)
+{
+    (void)buffers;
+    int tiles = 0;
+    hexDisc disc;
+    StartDisc(&disc, centre, radius);
+    for (hexCoord coord; NextDiscTile(&disc, &coord); tiles++)
+    {
+        *sum += QueryTileHash(coord);
+    }
+    return tiles;
+}
+
+static int QueryDiscRuns(hexCoord centre, int radius, const queryBuffers *buffers, uint64_t *sum)
+{
+    (void)buffers;
+    int tiles = 0;
+    hexDisc disc;
+    StartDisc(&disc, centre, radius);
+    hexCoord first;
+    int count;
+    while (NextDiscRun(&disc, &first, &count))
+    {
+        for (int r = 0; r < count; r++)
+        {
+            *sum += QueryTileHash((hexCoord){first.q, first.r + r, first.s - r});
+        }
+        tiles += count;
+    }
+    return tiles;
+}
+
+// The square around the centre with a distance test, how the tiles around a tile were found before the disc
+static int QueryScan(hexCoord centre, int radius, const queryBuffers *buffers, uint64_t *sum)
+{
+    (void)buffers;
+    int tiles = 0;
+    for (int q = centre.q - radius; q <= centre.q + radius; q++)
+    {
+        for (int r = centre.r - radius; r <= centre.r + radius; r++)
+        {
+            hexCoord coord = {q, r, -q - r};
+            if (HexDistance(coord, centre) <= radius)
+            {
+                *sum += QueryTileHash(coord);
+                tiles++;
+            }
+        }
+    }
+    return tiles;
+}
+
+// A line from the centre to every tile of the ring
+static int QueryLines(hexCoord centre, int radius, const queryBuffers *buffers, uint64_t *sum)
+{
+    (void)buffers;
+    int tiles = 0;
+    hexRing ring;
+    StartRing(&ring, centre, radius);
+    for (hexCoord end; NextRingTile(&ring, &end);)
+    {
+        hexLine line;
+        StartLine(&line, centre, end);
+        for (hexCoord coord; NextLineTile(&line, &coord); tiles++)
+        {
+            *sum += QueryTileHash(coord);
+        }
+    }
+    return tiles;
+}
+
+// A flood fill where nothing blocks, so it reaches every tile of the disc
+static int QueryFlood(hexCoord centre, int radius, const queryBuffers *buffers, uint64_t *sum)
+{
+    int tiles = 0;
+    hexFlood flood;
+    StartFlood(&flood, centre, radius, buffers->queue, buffers->seen);
+    for (hexCoord coord; NextFloodTile(&flood, &coord); tiles++)
+    {
+        *sum += QueryTileHash(coord);
+        SpreadFlood(&flood, coord);
+    }
+    return tiles;
+}
+
+// The tile of the line from a to b at step i of n rounded straight from i / n, the iterator gets there by adding up
+// the steps. Rounds and breaks ties the same way
+static hexCoord ReferenceLineTile(hexCoord a, hexCoord b, int i, int n)
+{
+    if (n == 0)
+    {
+        return a;
+    }
+    int from[3] = {a.q, a.r, a.s};
+    int to[3] = {b.q, b.r, b.s};
+    int rounded[3];
+    int error[3];
+    for (int c = 0; c < 3; c++)
+    {
+        long long exact = (long long)from[c] * n + (long long)(to[c] - from[c]) * i;
+        long long whole = exact >= 0 ? exact / n : -((-exact + n - 1) / n);
+        long long remainder = exact - whole * n;
+        bool up = remainder * 2 >= n;
+        rounded[c] = (int)whole + up;
+        error[c] = (int)(up ? n - remainder : remainder);
+    }
+    if (error[0] > error[1] && error[0] > error[2])
+    {
+        rounded[0] = -rounded[1] - rounded[2];
+    }
+    else if (error[1] > error[2])
+    {
+        rounded[1] = -rounded[0] - rounded[2];
+    }
+    else
+    {
+        rounded[2] = -rounded[0] - rounded[1];
+    }
+    return (hexCoord){rounded[0], rounded[1], rounded[2]};
+}
+
+// What a query should add up, from the scan over the square around the centre the iterators replaced
+static uint64_t ReferenceQuerySum(const char *name, hexCoord centre, int radius)
+{
+    bool ring = strcmp(name, "ring") == 0;
+    bool lines = strcmp(name, "lines") == 0;
+    uint64_t sum = 0;
+    for (int q = centre.q - radius; q <= centre.q + radius; q++)
+    {
+        for (int r = centre.r - radius; r <= centre.r + radius; r++)
+        {
+            hexCoord coord = {q, r, -q - r};
+            int distance = HexDistance(coord, centre);
+            if ((ring || lines) && distance != radius)
+            {
+                continue;
+            }
+            if (distance > radius)
+            {
+                continue;
+            }
+            if (!lines)
+            {
+                sum += QueryTileHash(coord);
+                continue;
+            }
+            for (int i = 0; i <= radius; i++)
+            {
+                sum += QueryTileHash(ReferenceLineTile(centre, coord, i, radius));
+            }
+        }
+    }
+    return sum;
+}
+
+// A ring has 6 tiles per step of radius, every line to it has radius + 1 tiles and the rest cover the whole disc
+static int ExpectedQueryTiles(const char *name, int radius)
+{
+    int ringTiles = radius > 0 ? 6 * radius : 1;
+    if (strcmp(name, "ring") == 0)
+    {
+        return ringTiles;
+    }
+    return strcmp(name, "lines") == 0 ? ringTiles * (radius + 1) : HexTileCount(radius);
+}
+
+typedef struct hexQueryBench
+{
+    const char *name;
+    int (*run)(hexCoord centre, int radius, const queryBuffers *buffers, uint64_t *sum);
+} hexQueryBench;
+
+// Times every hex query for every radius and checks that it visits as many tiles as it should and the same tiles as
+// the scan over the square around the centre. The centre moves between queries so every query starts somewhere new
+static int BenchQuery(int argc, char **argv)
+{
+    sweep radii = {{1, 8, 32, 128}, 4};
+    int minTiles = 4000000;
+    for (int i = 0; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--radius") == 0)
+        {
+            ok = ParseSweep(argv[++i], &radii);
+        }
+        else if (ok && strcmp(argv[i], "--tiles") == 0)
+        {
+            minTiles = atoi(argv[++i]);
+            ok = minTiles > 0;
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return -1;
+        }
+    }
+
+    const hexQueryBench queries[] = {
+        {"ring", QueryRing},
+        {"spiral", QuerySpiral},
+        {"disc", QueryDisc},
+        {"discRuns", QueryDiscRuns},
+        {"scan", QueryScan},
+        {"lines", QueryLines},
+        {"flood", QueryFlood}};
+    printf("query,radius,queries,tilesPerQuery,nsPerTile,sum,match\n");
+    int result = 0;
+    for (int i = 0; i < radii.count && result == 0; i++)
+    {
+        int radius = radii.values[i];
+        if (radius < 0)
+        {
+            fprintf(stderr, "skipping radius %d\n", radius);
+            continue;
+        }
+        queryBuffers buffers = {
+            malloc(sizeof(hexCoord) * HexTileCount(radius)),
+            malloc(HexFloodSeenSize(radius))};
+        if (buffers.queue == NULL || buffers.seen == NULL)
+        {
+            free(buffers.queue);
+            free(buffers.seen);
+            return 1;
+        }
+
+        for (int k = 0; k < (int)(sizeof(queries) / sizeof(queries[0])); k++)
+        {
+            int expected = ExpectedQueryTiles(queries[k].name, radius);
+            int passes = minTiles / expected > 0 ? minTiles / expected : 1;
+            uint64_t sum = 0;
+            bool match = true;
+            double start = GetTimeSeconds();
+            for (int p = 0; p < passes; p++)
+            {
+                hexCoord centre = {p % 97 - 48, p % 89 - 44, 0};
+                centre.s = -centre.q - centre.r;
+                match &= queries[k].run(centre, radius, &buffers, &sum) == expected;
+            }
+            double time = GetTimeSeconds() - start;
+            // Outside the timing, the reference is far slower than the queries
+            uint64_t expectedSum = 0;
+            for (int p = 0; p < passes; p++)
+            {
+                hexCoord centre = {p % 97 - 48, p % 89 - 44, 0};
+                centre.s = -centre.q - centre.r;
+                expectedSum += ReferenceQuerySum(queries[k].name, centre, radius);
+            }
+            match &= sum == expectedSum;
+            printf("%s,%d,%d,%d,%.2f,%016llx,%s\n", queries[k].name, radius, passes, expected,
+                time * 1e9 / ((double)passes * expected), (unsigned long long)sum, match ? "ok" : "FAILED");
+            fflush(stdout);
+            if (!match)
+            {
+                result = 1;
+                break;
+            }
+        }
+        free(buffers.queue);
+        free(buffers.seen);
+    }
+    return result;
+}
+
+// Generates the same maps with a new arena for every map and with one arena kept between them, and checks that both
+// give the same tiles. Large ant counts used to live on the stack and crash long before they ran out of memory
+static int BenchArena(int argc, char **argv)
+{
+    int seeds = 20;
+    sweep radii = {{101, 1001}, 2};
+    sweep antCounts = {{60, 100000}, 2};
+    for (int i = 0; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--seeds") == 0)
+        {
+            seeds = atoi(argv[++i]);
+            ok = seeds > 0;
+        }
+        else if (ok && strcmp(argv[i], "--radius") == 0)
+        {
+            ok = ParseSweep(argv[++i], &radii);
+        }
+        else if (ok && strcmp(argv[i], "--ants") == 0)
+        {
+            ok = ParseSweep(argv[++i], &antCounts);
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return -1;
+        }
+    }
+
+    printf("mapRadius,antCount,seeds,arenaKB,freshMs,reusedMs,match\n");
+    hexMap map = {0};
+    arena scratch = {0};
+    for (int c = 0; c < radii.count * antCounts.count; c++)
+    {
+        generatorParams params = DefaultGeneratorParams();
+        params.mapRadius = radii.values[c / antCounts.count];
+        params.antCount = antCounts.values[c % antCounts.count];
+        if (!GeneratorParamsValid(params))
+        {
+            fprintf(stderr, "skipping mapRadius %d, antCount %d\n", params.mapRadius, params.antCount);
+            continue;
+        }
+
+        uint32_t freshHash = 0;
+        uint32_t reusedHash = 0;
+        bool ok = true;
+        double start = GetTimeSeconds();
+        for (int seed = 0; ok && seed < seeds; seed++)
+        {
+            params.seed = seed + 1;
+            ClearMap(&map);
+            ok = GenerateMap(&map, params, NULL);
+            freshHash = freshHash * 31 + HashRegion(&map, params.mapRadius);
+        }
+        double freshTime = GetTimeSeconds() - start;
+        start = GetTimeSeconds();
+        for (int seed = 0; ok && seed < seeds; seed++)
+        {
+            params.seed = seed + 1;
+            ClearMap(&map);
+            ok = GenerateMapInArena(&map, &scratch, params, NULL);
+            reusedHash = reusedHash * 31 + HashRegion(&map, params.mapRadius);
+        }
+        double reusedTime = GetTimeSeconds() - start;
+        if (!ok)
+        {
+            fprintf(stderr, "failed to generate a map with mapRadius %d, antCount %d\n", params.mapRadius, params.antCount);
+            ClearMap(&map);
+            FreeArena(&scratch);
+            return 1;
+        }
+
+        // The hashes include the time to read every tile, it is the same for both
+        bool match = freshHash == reusedHash;
+        printf("%d,%d,%d,%zu,%.3f,%.3f,%s\n", params.mapRadius, params.antCount, seeds,
+            GeneratorArenaSize(params) / 1024, freshTime * 1000 / seeds, reusedTime * 1000 / seeds, match ? "ok" : "FAILED");
+        fflush(stdout);
+        if (!match)
+        {
+            ClearMap(&map);
+            FreeArena(&scratch);
+            return 1;
+        }
+    }
+    ClearMap(&map);
+    FreeArena(&scratch);
+    return 0;
+}
+
+// Generates a batch of seeds on a pool of workers and writes a CSV row for every map, once for every worker count
+// so the scaling can be compared. The rows go to stdout unless --out is given, the timing goes to stderr
+static int BenchFarm(int argc, char **argv)
+{
+    generatorParams params = DefaultGeneratorParams();
+    params.seed = 1;
+    // Every map is generated on one thread, the workers are where the parallelism comes from
+    params.threads = 1;
+    long long seeds = 1000;
+    sweep workerCounts = {{1, 2, 4, 8}, 4};
+    const char *path = NULL;
+    for (int i = 0; i < argc; i++)
+    {
+        bool ok = i + 1 < argc;
+        if (ok && strcmp(argv[i], "--seeds") == 0)
+        {
+            seeds = atoll(argv[++i]);
+            ok = seeds > 0;
+        }
+        else if (ok && strcmp(argv[i], "--seed") == 0)
+        {
+            params.seed = strtoull(argv[++i], NULL, 10);
+        }
+        else if (ok && strcmp(argv[i], "--radius") == 0)
+        {
+            params.mapRadius = atoi(argv[++i]);
+            ok = params.mapRadius % 2 == 1 && params.mapRadius / 2 - ANT_EDGE_MARGIN >= 1;
+        }
+        else if (ok && strcmp(argv[i], "--workers") == 0)
+        {
+            ok = ParseSweep(argv[++i], &workerCounts);
+        }
+        else if (ok && strcmp(argv[i], "--out") == 0)
+        {
+            path = argv[++i];
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            return -1;
+        }
+    }
+
+    FILE *out = path == NULL ? stdout : fopen(path, "w");
+    if (out == NULL)
+    {
+        fprintf(stderr, "failed to write %s\n", path);
+        return 1;
+    }
+    WriteFarmHeader(out);
+    // The scaling is only as good as the cores the machine has
+    fprintf(stderr, "%ld cores online\n", sysconf(_SC_NPROCESSORS_ONLN));
+    double baseRate = 0;
+    bool rowsWritten = false;
+    int result = 0;
+    for (int a = 0; a < workerCounts.count; a++)
+    {
+        if (workerCounts.values[a] < 1)
+        {
+            fprintf(stderr, "skipping %d workers\n", workerCounts.values[a]);
+            continue;
+        }
+        // Every worker count generates the same seeds, their rows are only written the first time
+        farmSummary summary;
+        if (!RunWorldFarm(params, seeds, workerCounts.values[a], rowsWritten ? NULL : out, &summary))
+        {
+            fprintf(stderr, "failed to start the workers\n");
+            result = 1;
+            break;
+        }
+        rowsWritten = true;
+        double rate = summary.maps / summary.time;
+        baseRate = baseRate > 0 ? baseRate : rate / summary.workers;
+        fprintf(stderr, "mapRadius %d, %d workers: %lld maps in %.1f ms, %lld failed, %.1f maps/s, %.2f per worker\n",
+            params.mapRadius, summary.workers, summary.maps, summary.time * 1000, summary.failed, rate,
+            rate / baseRate / summary.workers);
+        result = summary.failed > 0 ? 1 : result;
+    }
+    if (out != stdout && fclose(out) != 0)
+    {
+        fprintf(stderr, "failed to write %s\n", path);
+        result = 1;
+    }
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    int result;
+    if (argc > 1 && strcmp(argv[1], "farm") == 0)
+    {
+        result = BenchFarm(argc - 2, argv + 2);
+    }
+    else if (argc > 1 && strcmp(argv[1], "swarm") == 0)
+    {
+        result = BenchSwarm(argc - 2, argv + 2);
+    }
+    else if (argc > 1 && strcmp(argv[1], "query") == 0)
+    {
+        result = BenchQuery(argc - 2, argv + 2);
+    }
+    else if (argc > 1 && strcmp(argv[1], "arena") == 0)
+    {
+        result = BenchArena(argc - 2, argv + 2);
+    }
+    else if (argc > 1 && strcmp(argv[1], "render") == 0)
+    {
+        result = BenchRender(argc - 2, argv + 2);
+    }
+    else if (argc > 1 && strcmp(argv[1], "raster") == 0)
+    {
+        result = BenchRaster(argc - 2, argv + 2);
+    }
+    else if (argc > 1 && strcmp(argv[1], "replay") == 0)
+    {
+        result = BenchReplay(argc - 2, argv + 2);
+    }
+    else if (argc > 1 && strcmp(argv[1], "classify") == 0)
+    {
+        result = BenchClassify(argc - 2, argv + 2);
+    }
+    else if (argc > 1 && strcmp(argv[1], "tune") == 0)
+    {
+        result = BenchTune(argc - 2, argv + 2);
+    }
+    else if (argc > 1 && strcmp(argv[1], "access") == 0)
+    {
+        result = BenchAccess(argc - 2, argv + 2);
+    }
+    else if (argc > 1 && strcmp(argv[1], "snapshot") == 0)
+    {
+        result = BenchSnapshot(argc - 2, argv + 2);
+    }
+    else if (argc > 1 && strcmp(argv[1], "stream") == 0)
+    {
+        result = BenchStream(argc - 2, argv + 2);
+    }
+    else if (argc > 1 && strcmp(argv[1], "generate") == 0)
+    {
+        result = BenchGenerate(argc - 2, argv + 2);
+    }
+    else
+    {
+        result = BenchGenerate(argc - 1, argv + 1);
+    }
+
+    if (result < 0)
+    {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+    return result;
+}
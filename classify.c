@@ -0,0 +1,177 @@
+#include "classify.h"
+#include "map.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+int ClassifyTrailsScalar(const int *trails, uint8_t *tiles, int count, int *rooms)
+{
+    int roomCount = 0;
+    for (int i = 0; i < count; i++)
+    {
+        tiles[i] = trails[i] == -1 ? TILETYPE_WALL : TILETYPE_FLOOR;
+        if (trails[i] <= -2)
+        {
+            rooms[roomCount++] = i;
+        }
+    }
+    return roomCount;
+}
+
+// WALL is FLOOR + 1 so a tile is FLOOR minus the compare mask, which is -1 for walls and 0 otherwise.
+// Rooms are rare, a block only gets looked at tile by tile when one of its trails is below -1
+#if defined(__AVX2__)
+
+const char *ClassifyBackend(void)
+{
+    return "avx2";
+}
+
+int ClassifyTrails(const int *trails, uint8_t *tiles, int count, int *rooms)
+{
+    const __m256i minusOne = _mm256_set1_epi32(-1);
+    const __m256i floor = _mm256_set1_epi8(TILETYPE_FLOOR);
+    // Packing works within each 128 bit half, this puts the ints back in order
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    int roomCount = 0;
+    int i = 0;
+    for (; i + 32 <= count; i += 32)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(trails + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(trails + i + 8));
+        __m256i c = _mm256_loadu_si256((const __m256i *)(trails + i + 16));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(trails + i + 24));
+        __m256i walls = _mm256_packs_epi16(
+            _mm256_packs_epi32(_mm256_cmpeq_epi32(a, minusOne), _mm256_cmpeq_epi32(b, minusOne)),
+            _mm256_packs_epi32(_mm256_cmpeq_epi32(c, minusOne), _mm256_cmpeq_epi32(d, minusOne)));
+        walls = _mm256_permutevar8x32_epi32(walls, order);
+        _mm256_storeu_si256((__m256i *)(tiles + i), _mm256_sub_epi8(floor, walls));
+
+        __m256i low = _mm256_or_si256(
+            _mm256_or_si256(_mm256_cmpgt_epi32(minusOne, a), _mm256_cmpgt_epi32(minusOne, b)),
+            _mm256_or_si256(_mm256_cmpgt_epi32(minusOne, c), _mm256_cmpgt_epi32(minusOne, d)));
+        if (!_mm256_testz_si256(low, low))
+        {
+            int found = ClassifyTrailsScalar(trails + i, tiles + i, 32, rooms + roomCount);
+            for (int k = roomCount; k < roomCount + found; k++)
+            {
+                rooms[k] += i;
+            }
+            roomCount += found;
+        }
+    }
+    int tail = ClassifyTrailsScalar(trails + i, tiles + i, count - i, rooms + roomCount);
+    for (int k = roomCount; k < roomCount + tail; k++)
+    {
+        rooms[k] += i;
+    }
+    return roomCount + tail;
+}
+
+#elif defined(__SSE2__)
+
+const char *ClassifyBackend(void)
+{
+    return "sse2";
+}
+
+int ClassifyTrails(const int *trails, uint8_t *tiles, int count, int *rooms)
+{
+    const __m128i minusOne = _mm_set1_epi32(-1);
+    const __m128i floor = _mm_set1_epi8(TILETYPE_FLOOR);
+    int roomCount = 0;
+    int i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i *)(trails + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(trails + i + 4));
+        __m128i c = _mm_loadu_si128((const __m128i *)(trails + i + 8));
+        __m128i d = _mm_loadu_si128((const __m128i *)(trails + i + 12));
+        __m128i walls = _mm_packs_epi16(
+            _mm_packs_epi32(_mm_cmpeq_epi32(a, minusOne), _mm_cmpeq_epi32(b, minusOne)),
+            _mm_packs_epi32(_mm_cmpeq_epi32(c, minusOne), _mm_cmpeq_epi32(d, minusOne)));
+        _mm_storeu_si128((__m128i *)(tiles + i), _mm_sub_epi8(floor, walls));
+
+        __m128i low = _mm_or_si128(
+            _mm_or_si128(_mm_cmplt_epi32(a, minusOne), _mm_cmplt_epi32(b, minusOne)),
+            _mm_or_si128(_mm_cmplt_epi32(c, minusOne), _mm_cmplt_epi32(d, minusOne)));
+        if (_mm_movemask_epi8(low) != 0)
+        {
+            int found = ClassifyTrailsScalar(trails + i, tiles + i, 16, rooms + roomCount);
+            for (int k = roomCount; k < roomCount + found; k++)
+            {
+                rooms[k] += i;
+            }
+            roomCount += found;
+        }
+    }
+    int tail = ClassifyTrailsScalar(trails + i, tiles + i, count - i, rooms + roomCount);
+    for (int k = roomCount; k < roomCount + tail; k++)
+    {
+        rooms[k] += i;
+    }
+    return roomCount + tail;
+}
+
+#elif defined(__ARM_NEON)
+
+const char *ClassifyBackend(void)
+{
+    return "neon";
+}
+
+int ClassifyTrails(const int *trails, uint8_t *tiles, int count, int *rooms)
+{
+    const int32x4_t minusOne = vdupq_n_s32(-1);
+    const uint8x16_t floor = vdupq_n_u8(TILETYPE_FLOOR);
+    int roomCount = 0;
+    int i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        int32x4_t a = vld1q_s32(trails + i);
+        int32x4_t b = vld1q_s32(trails + i + 4);
+        int32x4_t c = vld1q_s32(trails + i + 8);
+        int32x4_t d = vld1q_s32(trails + i + 12);
+        uint8x16_t walls = vcombine_u8(
+            vmovn_u16(vcombine_u16(vmovn_u32(vceqq_s32(a, minusOne)), vmovn_u32(vceqq_s32(b, minusOne)))),
+            vmovn_u16(vcombine_u16(vmovn_u32(vceqq_s32(c, minusOne)), vmovn_u32(vceqq_s32(d, minusOne)))));
+        vst1q_u8(tiles + i, vsubq_u8(floor, walls));
+
+        uint32x4_t low = vorrq_u32(
+            vorrq_u32(vcltq_s32(a, minusOne), vcltq_s32(b, minusOne)),
+            vorrq_u32(vcltq_s32(c, minusOne), vcltq_s32(d, minusOne)));
+        uint32x2_t halves = vorr_u32(vget_low_u32(low), vget_high_u32(low));
+        if (vget_lane_u64(vreinterpret_u64_u32(halves), 0) != 0)
+        {
+            int found = ClassifyTrailsScalar(trails + i, tiles + i, 16, rooms + roomCount);
+            for (int k = roomCount; k < roomCount + found; k++)
+            {
+                rooms[k] += i;
+            }
+            roomCount += found;
+        }
+    }
+    int tail = ClassifyTrailsScalar(trails + i, tiles + i, count - i, rooms + roomCount);
+    for (int k = roomCount; k < roomCount + tail; k++)
+    {
+        rooms[k] += i;
+    }
+    return roomCount + tail;
+}
+
+#else
+
+const char *ClassifyBackend(void)
+{
+    return "scalar";
+}
+
+int ClassifyTrails(const int *trails, uint8_t *tiles, int count, int *rooms)
+{
+    return ClassifyTrailsScalar(trails, tiles, count, rooms);
+}
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef CLASSIFY_H
+#define CLASSIFY_H
+
+#include <stdint.h>
+
+// Turns a row of trails into tiles, -1 becomes a wall and everything else floor. The offsets of the room seeds
+// (-2 and less) in the row are written to rooms, which needs room for count offsets, returns how many there were.
+// Uses AVX2, SSE2 or NEON when the compiler targets them
+int ClassifyTrails(const int *trails, uint8_t *tiles, int count, int *rooms);
+// The same one tile at a time, to compare against
+int ClassifyTrailsScalar(const int *trails, uint8_t *tiles, int count, int *rooms);
+// The instruction set ClassifyTrails was compiled for
+const char *ClassifyBackend(void);
+
+#endif
@@ -0,0 +1,120 @@
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "farm.h"
+#include "hexquery.h"
+
+typedef struct worldFarm
+{
+    generatorParams params;
+    long long seeds;
+    // The index of the next seed a worker takes
+    atomic_llong next;
+    atomic_llong failed;
+    // Only held while a row is written
+    pthread_mutex_t lock;
+    FILE *out;
+} worldFarm;
+
+void WriteFarmHeader(FILE *out)
+{
+    fputs("seed,ok,floorRatio,rooms,networks,reachable,longestCorridor,ms\n", out);
+}
+
+void WriteFarmResult(FILE *out, const farmResult *result)
+{
+    fprintf(out, "%llu,%d,%.4f,%d,%d,%.4f,%d,%.3f\n", (unsigned long long)result->seed, result->ok,
+        result->floorRatio, result->rooms, result->networks, result->reachable, result->longestCorridor,
+        result->time * 1000);
+}
+
+static farmResult MeasureMap(hexMap *map, arena *scratch, generatorParams params)
+{
+    farmResult result = {.seed = params.seed};
+    generatorStats stats;
+    double start = GetTimeSeconds();
+    result.ok = GenerateMapInArena(map, scratch, params, &stats);
+    result.time = GetTimeSeconds() - start;
+    if (!result.ok)
+    {
+        return result;
+    }
+
+    result.floorRatio = (double)stats.floorTiles / HexTileCount(params.mapRadius / 2);
+    result.rooms = stats.rooms;
+    result.networks = stats.networks;
+    result.reachable = stats.floorTiles > 0 ? (double)stats.reachableTiles / stats.floorTiles : 0;
+    result.longestCorridor = stats.longestCorridor;
+    return result;
+}
+
+static void *RunFarmWorker(void *data)
+{
+    worldFarm *farm = data;
+    hexMap map = {0};
+    // Reserved by the first map and used again by every map after it
+    arena scratch = {0};
+    for (;;)
+    {
+        long long index = atomic_fetch_add(&farm->next, 1);
+        if (index >= farm->seeds)
+        {
+            break;
+        }
+        generatorParams params = farm->params;
+        params.seed += index;
+        ClearMap(&map);
+        farmResult result = MeasureMap(&map, &scratch, params);
+        if (!result.ok)
+        {
+            atomic_fetch_add(&farm->failed, 1);
+        }
+
+        if (farm->out != NULL)
+        {
+            pthread_mutex_lock(&farm->lock);
+            WriteFarmResult(farm->out, &result);
+            fflush(farm->out);
+            pthread_mutex_unlock(&farm->lock);
+        }
+    }
+    ClearMap(&map);
+    FreeArena(&scratch);
+    return NULL;
+}
+
+bool RunWorldFarm(generatorParams params, long long seeds, int workers, FILE *out, farmSummary *summary)
+{
+    worldFarm farm = {.params = params, .seeds = seeds, .out = out};
+    // The reachable fraction comes from the flood fill
+    farm.params.validate = true;
+    atomic_init(&farm.next, 0);
+    atomic_init(&farm.failed, 0);
+    if (pthread_mutex_init(&farm.lock, NULL) != 0)
+    {
+        return false;
+    }
+
+    double start = GetTimeSeconds();
+    pthread_t threads[workers];
+    int started = 0;
+    while (started < workers && pthread_create(&threads[started], NULL, RunFarmWorker, &farm) == 0)
+    {
+        started++;
+    }
+    // The workers that did start take every seed between them
+    for (int t = 0; t < started; t++)
+    {
+        pthread_join(threads[t], NULL);
+    }
+    pthread_mutex_destroy(&farm.lock);
+
+    if (summary != NULL)
+    {
+        summary->maps = seeds;
+        summary->failed = atomic_load(&farm.failed);
+        summary->workers = started;
+        summary->time = GetTimeSeconds() - start;
+    }
+    return started > 0;
+}
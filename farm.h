@@ -0,0 +1,44 @@
+#ifndef FARM_H
+#define FARM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "generator.h"
+
+// What a generated map looks like, used to pick good seeds without looking at every map
+typedef struct farmResult
+{
+    uint64_t seed;
+    bool ok;
+    // Floor tiles over all the tiles of the hexagon
+    double floorRatio;
+    int rooms;
+    int networks;
+    // Floor tiles reachable from the centre over all floor tiles, 1 unless something is walled off
+    double reachable;
+    // Walls carved by the longest corridor between two networks
+    int longestCorridor;
+    // Seconds it took to generate the map on its worker
+    double time;
+} farmResult;
+
+typedef struct farmSummary
+{
+    long long maps;
+    long long failed;
+    int workers;
+    // Wall time of the whole batch in seconds
+    double time;
+} farmSummary;
+
+// Generates seeds maps from params.seed on, one after the other, spread over workers threads. Every worker generates
+// into its own map so nothing is shared but the next seed to take and the output. A CSV row is written to out as soon
+// as a map is done, so the rows come in the order the maps finished and not by seed, out can be NULL to only time the
+// batch. Returns false if no worker could be started
+bool RunWorldFarm(generatorParams params, long long seeds, int workers, FILE *out, farmSummary *summary);
+void WriteFarmHeader(FILE *out);
+void WriteFarmResult(FILE *out, const farmResult *result);
+
+#endif
@@ -0,0 +1,197 @@
+#include <stdlib.h>
+
+#include "fov.h"
+#include "hexquery.h"
+
+static bool BlocksView(TILETYPE tile)
+{
+    return tile == TILETYPE_WALL || tile == TILETYPE_NONE;
+}
+
+static uint32_t TileHash(hexCoord coord)
+{
+    uint32_t h = (uint32_t)coord.q * 0x9E3779B1u ^ (uint32_t)coord.r * 0x85EBCA77u;
+    return h ^ h >> 16;
+}
+
+bool InitFovCache(fovCache *cache, int radius)
+{
+    *cache = (fovCache){0};
+    cache->radius = radius;
+    cache->capacity = HexTileCount(radius);
+    // Every shadow is at least 1 / radius wide and they all lie within -0.5 to 1.5, the row's shadows come after them
+    cache->shadowCapacity = 2 * radius + 2;
+    cache->shadows = malloc(sizeof(float) * 2 * (cache->shadowCapacity + radius + 1));
+    if (cache->shadows == NULL)
+    {
+        return false;
+    }
+    for (int i = 0; i < FOV_CACHE_SIZE; i++)
+    {
+        cache->sets[i].tiles = malloc(sizeof(seenTile) * cache->capacity);
+        if (cache->sets[i].tiles == NULL)
+        {
+            FreeFovCache(cache);
+            return false;
+        }
+    }
+    return true;
+}
+
+void FreeFovCache(fovCache *cache)
+{
+    for (int i = 0; i < FOV_CACHE_SIZE; i++)
+    {
+        free(cache->sets[i].tiles);
+    }
+    free(cache->shadows);
+    *cache = (fovCache){0};
+}
+
+static int CompareSeenTiles(const void *a, const void *b)
+{
+    const seenTile *x = a;
+    const seenTile *y = b;
+    if (x->coord.q != y->coord.q)
+    {
+        return x->coord.q < y->coord.q ? -1 : 1;
+    }
+    return x->coord.r < y->coord.r ? -1 : x->coord.r > y->coord.r;
+}
+
+static void AddVisible(visibleSet *set, hexCoord coord, TILETYPE tile)
+{
+    set->tiles[set->count++] = (seenTile){coord, tile};
+}
+
+// Adds the range to the sorted list of shadows, merging it with the shadows it overlaps
+static void AddShadow(float *shadows, int *count, float start, float end)
+{
+    int first = 0;
+    while (first < *count && shadows[first * 2 + 1] < start)
+    {
+        first++;
+    }
+    int last = first;
+    while (last < *count && shadows[last * 2] <= end)
+    {
+        start = shadows[last * 2] < start ? shadows[last * 2] : start;
+        end = shadows[last * 2 + 1] > end ? shadows[last * 2 + 1] : end;
+        last++;
+    }
+
+    // The shadows from first to last are replaced by one
+    int shift = 1 - (last - first);
+    if (shift > 0)
+    {
+        for (int k = *count - 1; k >= last; k--)
+        {
+            shadows[(k + shift) * 2] = shadows[k * 2];
+            shadows[(k + shift) * 2 + 1] = shadows[k * 2 + 1];
+        }
+    }
+    else if (shift < 0)
+    {
+        for (int k = last; k < *count; k++)
+        {
+            shadows[(k + shift) * 2] = shadows[k * 2];
+            shadows[(k + shift) * 2 + 1] = shadows[k * 2 + 1];
+        }
+    }
+    *count += shift;
+    shadows[first * 2] = start;
+    shadows[first * 2 + 1] = end;
+}
+
+// Shadowcasting over one of the six triangles around the origin. Row d is the straight line of d + 1 tiles from
+// d * corner to d * the next corner, a ray from the origin crosses every row at the same fraction of its length, so
+// shadows are kept as ranges of that fraction. Tile i of row d covers (i - 0.5) / d to (i + 0.5) / d.
+// The last tile of a row is the first tile of the next triangle's row, it blocks the view here but is added there
+static void CastSextant(fovCache *cache, hexMap *map, visibleSet *set, int sextant)
+{
+    // Sorted ranges that don't overlap as start and end pairs, the tiles of a row only shadow the rows behind it
+    float *shadows = cache->shadows;
+    float *rowShadows = cache->shadows + cache->shadowCapacity * 2;
+    int shadowCount = 0;
+
+    for (int d = 1; d <= cache->radius; d++)
+    {
+        int rowShadowCount = 0;
+        // The row is the side of the ring of radius d in this triangle and the first tile of the next side
+        hexRing row;
+        StartRingAtSide(&row, set->origin, d, sextant);
+        hexCoord coord;
+        for (int i = 0; i <= d && NextRingTile(&row, &coord); i++)
+        {
+            cache->lastTilesCast++;
+            float start = (i - 0.5f) / d;
+            float end = (i + 0.5f) / d;
+            float centre = (float)i / d;
+            bool centreLit = true;
+            // Walks the shadows over the tile to see if any part of it is left uncovered
+            float covered = start;
+            for (int s = 0; s < shadowCount && shadows[s * 2] <= end; s++)
+            {
+                if (centre >= shadows[s * 2] && centre <= shadows[s * 2 + 1])
+                {
+                    centreLit = false;
+                }
+                if (shadows[s * 2] <= covered && shadows[s * 2 + 1] > covered)
+                {
+                    covered = shadows[s * 2 + 1];
+                }
+            }
+            bool partLit = covered < end;
+
+            TILETYPE tile = GetTile(map, coord);
+            bool blocks = BlocksView(tile);
+            // Floors have to have their centre in view, walls are seen as long as any part of them is
+            if (i < d && (blocks ? partLit : centreLit))
+            {
+                AddVisible(set, coord, tile);
+            }
+            if (blocks && partLit)
+            {
+                rowShadows[rowShadowCount * 2] = start;
+                rowShadows[rowShadowCount * 2 + 1] = end;
+                rowShadowCount++;
+            }
+        }
+
+        for (int s = 0; s < rowShadowCount; s++)
+        {
+            AddShadow(shadows, &shadowCount, rowShadows[s * 2], rowShadows[s * 2 + 1]);
+        }
+        // Nothing behind this row can be seen
+        if (shadowCount == 1 && shadows[0] <= 0 && shadows[1] >= 1)
+        {
+            return;
+        }
+    }
+}
+
+const visibleSet *GetFieldOfView(fovCache *cache, hexMap *map, hexCoord origin)
+{
+    visibleSet *set = &cache->sets[TileHash(origin) % FOV_CACHE_SIZE];
+    if (set->valid && set->origin.q == origin.q && set->origin.r == origin.r &&
+        !MapChangedAround(map, origin, cache->radius, set->revision))
+    {
+        cache->hits++;
+        cache->lastTilesCast = 0;
+        return set;
+    }
+
+    cache->misses++;
+    cache->lastTilesCast = 1;
+    set->origin = origin;
+    set->revision = MapRevision(map);
+    set->valid = true;
+    set->count = 0;
+    AddVisible(set, origin, GetTile(map, origin));
+    for (int sextant = 0; sextant < 6; sextant++)
+    {
+        CastSextant(cache, map, set, sextant);
+    }
+    qsort(set->tiles, set->count, sizeof(seenTile), CompareSeenTiles);
+    return set;
+}
@@ -0,0 +1,52 @@
+#ifndef FOV_H
+#define FOV_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "map.h"
+
+typedef struct seenTile
+{
+    hexCoord coord;
+    // The tile type when the set was computed
+    TILETYPE tile;
+} seenTile;
+
+// The tiles that can be seen from a tile, walls and tiles that haven't been generated block the view.
+// Sorted by q and then r, the order the renderer draws in so overlapping walls look the same from everywhere
+typedef struct visibleSet
+{
+    hexCoord origin;
+    int count;
+    seenTile *tiles;
+    // The map revision the set was computed at, the set is stale once a chunk within its radius changes
+    uint32_t revision;
+    bool valid;
+} visibleSet;
+
+// Visible sets picked by a hash of the tile they were cast from, a tile whose hash lands on a taken entry replaces it
+#define FOV_CACHE_SIZE 64
+
+typedef struct fovCache
+{
+    int radius;
+    // Tiles within radius of a tile, the most a set can hold
+    int capacity;
+    visibleSet sets[FOV_CACHE_SIZE];
+    // Scratch space for the shadows while casting
+    float *shadows;
+    int shadowCapacity;
+    long long hits;
+    long long misses;
+    // Tiles the last call looked at, 0 if its set came from the cache
+    int lastTilesCast;
+} fovCache;
+
+bool InitFovCache(fovCache *cache, int radius);
+// Returns the tiles within radius of origin that can be seen from it, computed with shadowcasting unless they are
+// already cached for this tile and the map hasn't changed since. A cache is only ever used with one map
+const visibleSet *GetFieldOfView(fovCache *cache, hexMap *map, hexCoord origin);
+void FreeFovCache(fovCache *cache);
+
+#endif
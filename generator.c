@@ -0,0 +1,1346 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "generator.h"
+#include "rng.h"
+#include "classify.h"
+#include "hexquery.h"
+
+const char *generatorPhaseNames[GENERATORPHASE_COUNT] = {
+    "reserve",
+    "place",
+    "firstPass",
+    "merge",
+    "connect",
+    "interpret"};
+
+const char *generatorLogNames[GENERATORLOG_COUNT] = {
+    "quiet",
+    "warning",
+    "info",
+    "trace"};
+
+generatorParams DefaultGeneratorParams(void)
+{
+    return (generatorParams){
+        .mapRadius = 101,
+        .turnChanceDenominator = 3,
+        .antCount = 60,
+        .roomRadius = 4,
+        .origin = (hexCoord){0, 0, 0},
+        .seed = 1,
+        .threads = 1,
+        .logLevel = GENERATORLOG_WARNING,
+        .validate = false,
+        .keepTrails = false};
+}
+
+bool GeneratorParamsValid(generatorParams params)
+{
+    // The ants need room to be placed, a single ant never collides so its pass would never end
+    return params.mapRadius % 2 == 1 && params.mapRadius / 2 - ANT_EDGE_MARGIN >= 1 && params.antCount >= 2 &&
+        params.threads >= 1 && params.turnChanceDenominator > 0 && params.roomRadius >= 0;
+}
+
+// Only called with valid params, so there is always at least one thread and one ant per thread
+static int GeneratorThreadCount(generatorParams params)
+{
+    return params.threads > params.antCount ? params.antCount : params.threads;
+}
+
+generatorParams DefaultChunkParams(void)
+{
+    generatorParams params = DefaultGeneratorParams();
+    params.mapRadius = CHUNK_SIZE - 1;
+    params.antCount = 30;
+    return params;
+}
+
+// Writes the message to stderr if the log level lets it through, stderr isn't buffered so it is kept off the hot paths
+static void GeneratorLog(GENERATORLOG logLevel, GENERATORLOG level, const char *format, ...)
+{
+    if (level > logLevel)
+    {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+}
+
+// Adds the time since the last call to the phase, so every phase is timed from where the one before it ended
+typedef struct phaseTimer
+{
+    generatorStats *stats;
+    double start;
+} phaseTimer;
+
+static phaseTimer StartPhaseTimer(generatorStats *stats)
+{
+    return (phaseTimer){stats, GetTimeSeconds()};
+}
+
+static void EndPhase(phaseTimer *timer, GENERATORPHASE phase)
+{
+    double now = GetTimeSeconds();
+    timer->stats->phaseTime[phase] += now - timer->start;
+    timer->start = now;
+}
+
+// The ants' trails are kept in a scratch buffer while generating, the map only gets the final tiles.
+// The buffer is mapRadius rows of mapRadius ints, one row per q, with the centre tile in the middle. A coordinate is one
+// multiply-add away from its slot and moving in a direction always changes the slot by the same offset
+typedef struct trailGrid
+{
+    int *cells;
+    // The slot of the tile q = 0, r = 0, slots are relative to it
+    int *centre;
+    int stride;
+    int neighbourOffsets[6];
+} trailGrid;
+
+static size_t TrailGridSize(int mapRadius)
+{
+    return sizeof(int) * mapRadius * mapRadius;
+}
+
+static bool CreateTrailGrid(trailGrid *grid, arena *scratch, int mapRadius)
+{
+    grid->cells = ArenaAlloc(scratch, TrailGridSize(mapRadius));
+    if (grid->cells == NULL)
+    {
+        return false;
+    }
+    grid->stride = mapRadius;
+    grid->centre = grid->cells + (mapRadius / 2) * mapRadius + mapRadius / 2;
+    for (int d = 0; d < 6; d++)
+    {
+        grid->neighbourOffsets[d] = directionToCoords[d].q * grid->stride + directionToCoords[d].r;
+    }
+    // Every byte of -1 is 0xff so this sets every tile to -1, nothing has been there yet
+    memset(grid->cells, 0xff, TrailGridSize(mapRadius));
+    return true;
+}
+
+static int TrailSlot(const trailGrid *grid, hexCoord coord)
+{
+    return coord.q * grid->stride + coord.r;
+}
+
+// Carving through a wall costs more than following a trail so corridors reuse the floor that is already there.
+// The search is a weighted A*: the distance left is estimated as if it was all walls, which overestimates whenever
+// there is floor on the way, so the search heads for the target instead of visiting every cheap tile around it. The
+// corridor isn't always the cheapest, it can cost up to CORRIDOR_WALL_COST times as much, but estimating with the
+// floor cost made the connect phase 10 to 20 times slower
+#define CORRIDOR_FLOOR_COST 1
+#define CORRIDOR_WALL_COST 4
+// The A* heap starts with room for this many nodes and doubles when it is full
+#define CORRIDOR_HEAP_START 256
+
+typedef struct corridorNode
+{
+    // Cost so far plus the estimate for the rest
+    int priority;
+    int cost;
+    hexCoord coord;
+    int slot;
+} corridorNode;
+
+// A* over the trail grid, the arrays are shared by all searches and only reset by bumping search
+typedef struct corridorSearch
+{
+    trailGrid *trails;
+    // The heap is the last thing allocated from it so it grows in place
+    arena *scratch;
+    int limit;
+    // Per slot, relative to the centre like the trails. cost and from are only valid where visited == search
+    int *cost;
+    int *visited;
+    uint8_t *from;
+    int search;
+    corridorNode *heap;
+    int heapCount;
+    int heapCapacity;
+} corridorSearch;
+
+static bool PushCorridorNode(corridorSearch *search, corridorNode node)
+{
+    if (search->heapCount == search->heapCapacity)
+    {
+        int capacity = search->heapCapacity == 0 ? CORRIDOR_HEAP_START : search->heapCapacity * 2;
+        corridorNode *heap = ArenaGrow(search->scratch, search->heap,
+            sizeof(corridorNode) * search->heapCapacity, sizeof(corridorNode) * capacity);
+        if (heap == NULL)
+        {
+            return false;
+        }
+        search->heap = heap;
+        search->heapCapacity = capacity;
+    }
+    int i = search->heapCount++;
+    while (i > 0 && search->heap[(i - 1) / 2].priority > node.priority)
+    {
+        search->heap[i] = search->heap[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    search->heap[i] = node;
+    return true;
+}
+
+static corridorNode PopCorridorNode(corridorSearch *search)
+{
+    corridorNode top = search->heap[0];
+    corridorNode last = search->heap[--search->heapCount];
+    int i = 0;
+    while (true)
+    {
+        int child = i * 2 + 1;
+        if (child >= search->heapCount)
+        {
+            break;
+        }
+        if (child + 1 < search->heapCount && search->heap[child + 1].priority < search->heap[child].priority)
+        {
+            child++;
+        }
+        if (search->heap[child].priority >= last.priority)
+        {
+            break;
+        }
+        search->heap[i] = search->heap[child];
+        i = child;
+    }
+    search->heap[i] = last;
+    return top;
+}
+
+// Turns the walls on the straight line from a to b into floor owned by network, for when the search runs out of room.
+// The ends are inside the hexagon so the line is too, give or take the rounding of a tile the trails have room for
+static int CarveStraightCorridor(trailGrid *trails, hexCoord a, hexCoord b, int network)
+{
+    int carved = 0;
+    hexLine line;
+    StartLine(&line, a, b);
+    for (hexCoord coord; NextLineTile(&line, &coord);)
+    {
+        int *tile = &trails->centre[TrailSlot(trails, coord)];
+        if (*tile == -1)
+        {
+            *tile = network;
+            carved++;
+        }
+    }
+    return carved;
+}
+
+// Finds a cheap path from a to b inside the hexagon and turns the walls on it into floor owned by network. If the
+// heap can't grow the corridor is carved straight instead, so one long search doesn't cost the whole map. Returns the
+// number of walls carved
+static int CarveCorridor(corridorSearch *search, hexCoord a, hexCoord b, int network)
+{
+    trailGrid *trails = search->trails;
+    int target = TrailSlot(trails, b);
+    search->search++;
+    search->heapCount = 0;
+    int start = TrailSlot(trails, a);
+    search->visited[start] = search->search;
+    search->cost[start] = 0;
+    if (!PushCorridorNode(search, (corridorNode){HexDistance(a, b) * CORRIDOR_WALL_COST, 0, a, start}))
+    {
+        return CarveStraightCorridor(trails, a, b, network);
+    }
+
+    while (search->heapCount > 0)
+    {
+        corridorNode node = PopCorridorNode(search);
+        if (node.slot == target)
+        {
+            break;
+        }
+        // Skip nodes that were pushed again with a lower cost
+        if (node.cost > search->cost[node.slot])
+        {
+            continue;
+        }
+        for (int d = 0; d < 6; d++)
+        {
+            hexCoord next = HexCoordAdd(node.coord, directionToCoords[d]);
+            if (!InHexagon(next, search->limit))
+            {
+                continue;
+            }
+            int slot = node.slot + trails->neighbourOffsets[d];
+            int cost = node.cost + (trails->centre[slot] == -1 ? CORRIDOR_WALL_COST : CORRIDOR_FLOOR_COST);
+            if (search->visited[slot] == search->search && search->cost[slot] <= cost)
+            {
+                continue;
+            }
+            search->visited[slot] = search->search;
+            search->cost[slot] = cost;
+            search->from[slot] = (uint8_t)d;
+            if (!PushCorridorNode(search, (corridorNode){cost + HexDistance(next, b) * CORRIDOR_WALL_COST, cost, next, slot}))
+            {
+                return CarveStraightCorridor(trails, a, b, network);
+            }
+        }
+    }
+
+    // Walk back from b and carve the walls on the way, both ends are always inside the hexagon so b was reached
+    int carved = 0;
+    for (int slot = target; slot != start; slot -= trails->neighbourOffsets[search->from[slot]])
+    {
+        if (trails->centre[slot] == -1)
+        {
+            trails->centre[slot] = network;
+            carved++;
+        }
+    }
+    if (trails->centre[start] == -1)
+    {
+        trails->centre[start] = network;
+        carved++;
+    }
+    return carved;
+}
+
+// The bytes of every array a generation takes from the arena, grouped by how long they are kept. The phases allocate
+// with these sizes and GeneratorArenaSize adds them up, so the reservation always fits what is allocated. A group is
+// only made of size_t so it can be summed as an array
+typedef struct regionLayout
+{
+    // Kept for the whole generation
+    struct
+    {
+        size_t q, r, s, directions, alive, steps, slots;
+        size_t networks, networkRanks, rooms;
+        size_t trails;
+    } kept;
+    // Released once the networks are joined
+    struct
+    {
+        size_t buffers;
+    } firstPass;
+    // Kept from the merge on
+    struct
+    {
+        size_t nodes;
+    } merge;
+    // Released after the corridors are carved. The heap is allocated last so it grows in place, it is given room to
+    // double until it holds a node per tile, which is far more than a search ever holds
+    struct
+    {
+        size_t cost, visited, from;
+        size_t inTree, distance, parent;
+        size_t heap;
+    } connect;
+    // Kept until the end
+    struct
+    {
+        size_t tiles, rooms;
+    } rows;
+    // Released after the flood fill
+    struct
+    {
+        size_t seen, queue;
+    } flood;
+} regionLayout;
+
+static regionLayout RegionLayout(generatorParams params)
+{
+    size_t ants = params.antCount;
+    size_t threads = GeneratorThreadCount(params);
+    size_t cells = (size_t)params.mapRadius * params.mapRadius;
+    // The centre and the root of every network
+    size_t nodes = ants + 1;
+    size_t heapCapacity = CORRIDOR_HEAP_START;
+    while (heapCapacity < cells)
+    {
+        heapCapacity *= 2;
+    }
+    int half = params.mapRadius / 2;
+    return (regionLayout){
+        .kept = {
+            .q = sizeof(int) * ants,
+            .r = sizeof(int) * ants,
+            .s = sizeof(int) * ants,
+            .directions = sizeof(uint8_t) * ants,
+            .alive = sizeof(bool) * ants,
+            .steps = sizeof(int) * ants,
+            .slots = sizeof(int) * ants,
+            .networks = sizeof(int) * ants,
+            .networkRanks = ants,
+            // Every ant dies at most once so there can't be more rooms than ants
+            .rooms = sizeof(hexCoord) * ants,
+            .trails = TrailGridSize(params.mapRadius)},
+        // What the ants collided with, the active list, the moved list and their stripes, then the stripe offsets
+        .firstPass = {.buffers = sizeof(int) * (ants * 4 + threads * (threads + 1))},
+        .merge = {.nodes = sizeof(hexCoord) * nodes},
+        .connect = {
+            .cost = sizeof(int) * cells,
+            .visited = sizeof(int) * cells,
+            .from = cells,
+            .inTree = sizeof(bool) * nodes,
+            .distance = sizeof(int) * nodes,
+            .parent = sizeof(int) * nodes,
+            .heap = sizeof(corridorNode) * heapCapacity},
+        .rows = {.tiles = params.mapRadius, .rooms = sizeof(int) * params.mapRadius},
+        .flood = {.seen = HexFloodSeenSize(half), .queue = sizeof(hexCoord) * HexTileCount(half)}};
+}
+
+// The bytes a group of the layout takes from the arena
+static size_t LayoutGroupSize(const size_t *sizes, size_t count)
+{
+    size_t size = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        size += ArenaAllocSize(sizes[i]);
+    }
+    return size;
+}
+
+#define LAYOUT_GROUP_SIZE(group) LayoutGroupSize((const size_t *)&(group), sizeof(group) / sizeof(size_t))
+
+// Joins the nodes with a minimum spanning tree by hex distance (Prim's, the node count is at most the ant count)
+// and carves a corridor along every edge
+static bool ConnectNetworks(trailGrid *trails, arena *scratch, const regionLayout *layout, const hexCoord *nodes,
+    int nodeCount, int mapRadius, generatorStats *stats)
+{
+    size_t mark = ArenaMark(scratch);
+    int centre = (int)(trails->centre - trails->cells);
+    int *cost = ArenaAlloc(scratch, layout->connect.cost);
+    int *visited = ArenaAlloc(scratch, layout->connect.visited);
+    uint8_t *from = ArenaAlloc(scratch, layout->connect.from);
+    bool *inTree = ArenaAlloc(scratch, layout->connect.inTree);
+    int *distance = ArenaAlloc(scratch, layout->connect.distance);
+    int *parent = ArenaAlloc(scratch, layout->connect.parent);
+    if (cost == NULL || visited == NULL || from == NULL || inTree == NULL || distance == NULL || parent == NULL)
+    {
+        ArenaRelease(scratch, mark);
+        return false;
+    }
+    // The arena may hold the last generation's searches
+    memset(visited, 0, layout->connect.visited);
+    corridorSearch search = {
+        .trails = trails,
+        .scratch = scratch,
+        .limit = mapRadius / 2 - 1,
+        .cost = cost + centre,
+        .visited = visited + centre,
+        .from = from + centre};
+
+    for (int i = 0; i < nodeCount; i++)
+    {
+        inTree[i] = false;
+        distance[i] = HexDistance(nodes[i], nodes[0]);
+        parent[i] = 0;
+    }
+    inTree[0] = true;
+
+    for (int added = 1; added < nodeCount; added++)
+    {
+        int next = -1;
+        for (int i = 0; i < nodeCount; i++)
+        {
+            if (!inTree[i] && (next < 0 || distance[i] < distance[next]))
+            {
+                next = i;
+            }
+        }
+        inTree[next] = true;
+
+        // The corridor's tiles are owned by the index of the node it is carved from, not by an ant
+        int carved = CarveCorridor(&search, nodes[next], nodes[parent[next]], next);
+        stats->corridorTiles += carved;
+        stats->longestCorridor = carved > stats->longestCorridor ? carved : stats->longestCorridor;
+        for (int i = 0; i < nodeCount; i++)
+        {
+            int d = HexDistance(nodes[i], nodes[next]);
+            if (!inTree[i] && d < distance[i])
+            {
+                distance[i] = d;
+                parent[i] = next;
+            }
+        }
+    }
+
+    ArenaRelease(scratch, mark);
+    return true;
+}
+
+// Disjoint sets over the ant indices with path halving and union by rank
+static int FindNetwork(int *networks, int i)
+{
+    while (networks[i] != i)
+    {
+        networks[i] = networks[networks[i]];
+        i = networks[i];
+    }
+    return i;
+}
+
+static void UnionNetworks(int *networks, unsigned char *ranks, int a, int b)
+{
+    a = FindNetwork(networks, a);
+    b = FindNetwork(networks, b);
+    if (a == b)
+    {
+        return;
+    }
+    if (ranks[a] < ranks[b])
+    {
+        int t = a;
+        a = b;
+        b = t;
+    }
+    networks[b] = a;
+    ranks[a] += ranks[a] == ranks[b];
+}
+
+// Barrier between the steps of the first pass. A step only takes microseconds so the threads spin for a while before yielding
+typedef struct stepBarrier
+{
+    atomic_int waiting;
+    atomic_int generation;
+    int threads;
+} stepBarrier;
+
+static void WaitAtBarrier(stepBarrier *barrier)
+{
+    int generation = atomic_load(&barrier->generation);
+    if (atomic_fetch_add(&barrier->waiting, 1) == barrier->threads - 1)
+    {
+        atomic_store(&barrier->waiting, 0);
+        atomic_fetch_add(&barrier->generation, 1);
+        return;
+    }
+    for (int spins = 0; atomic_load(&barrier->generation) == generation; spins++)
+    {
+        if (spins > 1000)
+        {
+            sched_yield();
+        }
+    }
+}
+
+// State shared by the threads running the first pass.
+// Every step has two phases: each thread moves a contiguous range of ants, then each thread checks the tiles
+// of the ants that ended up in its stripe of the map in ant index order. Ants can only affect each other through
+// the tile they are on and every tile is in exactly one stripe, so the map is the same no matter the thread count
+typedef struct firstPass
+{
+    antSwarm ants;
+    uint64_t seed;
+    // The ant whose trail or room the ant died on, -1 if it hasn't collided
+    int *collidedWith;
+    int antCount;
+    trailGrid *trails;
+    int mapRadius;
+    int turnChanceDenominator;
+    GENERATORLOG logLevel;
+    int threads;
+    // The live ants of each thread in index order, a thread's list starts at the first ant of its range. Ants that
+    // died are dropped from it at the start of the next step
+    int *active;
+    // The ants moved by each thread this step, ordered by stripe and then index
+    int *moved;
+    // The stripe of each entry of active
+    int *antStripes;
+    // Where each thread's stripes start in moved, threads + 1 entries per thread
+    int *stripeOffsets;
+    struct firstPassWorker *workers;
+    stepBarrier barrier;
+    // The threads wait for start before touching anything and leave if abort is set instead
+    atomic_bool start;
+    atomic_bool abort;
+} firstPass;
+
+typedef struct firstPassWorker
+{
+    firstPass *pass;
+    int index;
+    int alive;
+    long long steps;
+    long long tilesTouched;
+    long long wallBounces;
+    long long escapes;
+    long long collisions;
+    // Keep the workers on separate cache lines since every thread updates its own counters
+    char padding[64];
+} firstPassWorker;
+
+// Turns and moves the ant, returns false if it escaped the map
+static bool StepAnt(firstPass *pass, firstPassWorker *worker, int i)
+{
+    antSwarm *ants = &pass->ants;
+    int half = pass->mapRadius / 2;
+
+    // Determine if the ant should turn, the random bits only depend on the seed, the ant and its step
+    uint64_t bits = RandomBits(pass->seed, RANDOMSTREAM_STEP, i, ants->steps[i]++);
+    int direction = ants->directions[i];
+    if (RandomRange(bits, 0, pass->turnChanceDenominator) == 0)
+    {
+        direction += ((bits & 1) == 0 ? -1 : 1);
+    }
+    // Keep the direction positive so turning left from 0 doesn't index outside directionToCoords
+    direction = (direction + 6) % 6;
+
+    // Move the ant
+    hexCoord move = directionToCoords[direction];
+    int q = ants->q[i] + move.q;
+    int r = ants->r[i] + move.r;
+    int s = ants->s[i] + move.s;
+    int slot = ants->slots[i] + pass->trails->neighbourOffsets[direction];
+
+    // If the ant is out of bounds, turn around
+    if (!InHexagon((hexCoord){q, r, s}, half - 1))
+    {
+        q -= move.q;
+        r -= move.r;
+        s -= move.s;
+        slot -= pass->trails->neighbourOffsets[direction];
+        direction = (direction + 3) % 6;
+        worker->wallBounces++;
+    }
+    ants->q[i] = q;
+    ants->r[i] = r;
+    ants->s[i] = s;
+    ants->slots[i] = slot;
+    ants->directions[i] = (uint8_t)direction;
+
+    // If the rest of the code works this should be redundant but the the issue could be hard to find without a warning
+    if (!InHexagon((hexCoord){q, r, s}, half))
+    {
+        ants->alive[i] = false;
+        worker->escapes++;
+        GeneratorLog(pass->logLevel, GENERATORLOG_WARNING, "ant %d escaped at q: %d, r: %d, s: %d\n", i, q, r, s);
+        return false;
+    }
+    return true;
+}
+
+// Checks the tile the ant moved to
+static void ResolveAnt(firstPass *pass, firstPassWorker *worker, int i)
+{
+    int *tile = &pass->trails->centre[pass->ants.slots[i]];
+    switch (*tile)
+    {
+    case -1:
+    {
+        // If the ant is on an unexplored tile, set the tile to the ant's index
+        *tile = i;
+        worker->tilesTouched++;
+    }
+    break;
+    default:
+    {
+        if (*tile != i)
+        {
+            // If the ant is on a tile that has been explored by another ant, kill the ant, track the collision and mark the tile for a room to be created later.
+            // Rooms are stored as -2 - the index of the ant that died there so an ant dying in a room joins that ant's network
+            pass->ants.alive[i] = false;
+            worker->collisions++;
+            pass->collidedWith[i] = *tile >= 0 ? *tile : -2 - *tile;
+            GeneratorLog(pass->logLevel, GENERATORLOG_TRACE, "ant %d died on the trail of ant %d\n", i, pass->collidedWith[i]);
+            *tile = -2 - i;
+        }
+    }
+    break;
+    }
+}
+
+static void *RunFirstPassWorker(void *data)
+{
+    firstPassWorker *worker = data;
+    firstPass *pass = worker->pass;
+    while (!atomic_load(&pass->start))
+    {
+        if (atomic_load(&pass->abort))
+        {
+            return NULL;
+        }
+        sched_yield();
+    }
+
+    int threads = pass->threads;
+    int first = (int)((long long)pass->antCount * worker->index / threads);
+    int last = (int)((long long)pass->antCount * (worker->index + 1) / threads);
+    int *offsets = pass->stripeOffsets + worker->index * (threads + 1);
+    int fill[threads];
+    int *active = pass->active + first;
+    int *activeStripes = pass->antStripes + first;
+    int activeCount = last - first;
+    for (int k = 0; k < activeCount; k++)
+    {
+        active[k] = first + k;
+    }
+
+    while (true)
+    {
+        // Move this thread's ants and sort them by the stripe they ended up in. The ants that died since the last step
+        // are dropped from the list as it is walked, the rest are moved up and stay in index order
+        for (int s = 0; s <= threads; s++)
+        {
+            offsets[s] = 0;
+        }
+        int kept = 0;
+        for (int k = 0; k < activeCount; k++)
+        {
+            int i = active[k];
+            if (pass->ants.alive[i] && StepAnt(pass, worker, i))
+            {
+                int stripe = (int)((long long)(pass->ants.q[i] + pass->mapRadius / 2) * threads / pass->mapRadius);
+                active[kept] = i;
+                activeStripes[kept] = stripe;
+                offsets[stripe + 1]++;
+                kept++;
+            }
+        }
+        activeCount = kept;
+        worker->alive = kept;
+        worker->steps += kept;
+        offsets[0] = first;
+        for (int s = 0; s < threads; s++)
+        {
+            offsets[s + 1] += offsets[s];
+            fill[s] = offsets[s];
+        }
+        for (int k = 0; k < activeCount; k++)
+        {
+            pass->moved[fill[activeStripes[k]]++] = active[k];
+        }
+        WaitAtBarrier(&pass->barrier);
+
+        int aliveAnts = 0;
+        for (int t = 0; t < threads; t++)
+        {
+            aliveAnts += pass->workers[t].alive;
+        }
+        if (aliveAnts == 0)
+        {
+            break;
+        }
+
+        // Check the tiles in this thread's stripe, going through the threads in order keeps the ants in index order
+        for (int t = 0; t < threads; t++)
+        {
+            int *stripes = pass->stripeOffsets + t * (threads + 1);
+            for (int k = stripes[worker->index]; k < stripes[worker->index + 1]; k++)
+            {
+                ResolveAnt(pass, worker, pass->moved[k]);
+            }
+        }
+        WaitAtBarrier(&pass->barrier);
+    }
+    return NULL;
+}
+
+// Runs the first pass on pass->threads threads, falls back to fewer threads if they can't be created
+static void RunFirstPass(firstPass *pass, generatorStats *stats)
+{
+    firstPassWorker workers[pass->threads];
+    pthread_t threads[pass->threads];
+    pass->workers = workers;
+
+    int started = 1;
+    for (; started < pass->threads; started++)
+    {
+        workers[started] = (firstPassWorker){.pass = pass, .index = started};
+        if (pthread_create(&threads[started], NULL, RunFirstPassWorker, &workers[started]) != 0)
+        {
+            break;
+        }
+    }
+    if (started < pass->threads)
+    {
+        // Let the threads that did start give up at the first barrier and run with what we have
+        atomic_store(&pass->abort, true);
+        for (int t = 1; t < started; t++)
+        {
+            pthread_join(threads[t], NULL);
+        }
+        started = 1;
+        pass->threads = 1;
+    }
+    pass->barrier.threads = pass->threads;
+    atomic_store(&pass->start, true);
+
+    // The calling thread is worker 0
+    workers[0] = (firstPassWorker){.pass = pass, .index = 0};
+    RunFirstPassWorker(&workers[0]);
+    for (int t = 1; t < started; t++)
+    {
+        pthread_join(threads[t], NULL);
+    }
+
+    for (int t = 0; t < pass->threads; t++)
+    {
+        stats->stepsWalked += workers[t].steps;
+        stats->tilesTouched += workers[t].tilesTouched;
+        stats->wallBounces += workers[t].wallBounces;
+        stats->escapes += workers[t].escapes;
+        stats->collisions += workers[t].collisions;
+    }
+}
+
+void WriteGeneratorStats(FILE *file, generatorParams params, const generatorStats *stats, STATSFORMAT format, bool header)
+{
+    // Every column once so the JSON keys and the CSV header can't drift apart
+    double total = 0;
+    for (int p = 0; p < GENERATORPHASE_COUNT; p++)
+    {
+        total += stats->phaseTime[p];
+    }
+    struct
+    {
+        const char *name;
+        double value;
+        // Times get three decimals, everything else is a whole number
+        bool time;
+    } fields[] = {
+        {"mapRadius", params.mapRadius, false},
+        {"antCount", params.antCount, false},
+        {"turnChanceDenominator", params.turnChanceDenominator, false},
+        {"roomRadius", params.roomRadius, false},
+        {"threads", params.threads, false},
+        {"originQ", params.origin.q, false},
+        {"originR", params.origin.r, false},
+        {"reserveMs", stats->phaseTime[GENERATORPHASE_RESERVE] * 1000, true},
+        {"placeMs", stats->phaseTime[GENERATORPHASE_PLACE] * 1000, true},
+        {"firstPassMs", stats->phaseTime[GENERATORPHASE_FIRSTPASS] * 1000, true},
+        {"mergeMs", stats->phaseTime[GENERATORPHASE_MERGE] * 1000, true},
+        {"connectMs", stats->phaseTime[GENERATORPHASE_CONNECT] * 1000, true},
+        {"interpretMs", stats->phaseTime[GENERATORPHASE_INTERPRET] * 1000, true},
+        {"carveMs", stats->roomTime * 1000, true},
+        {"totalMs", total * 1000, true},
+        {"stepsWalked", stats->stepsWalked, false},
+        {"wallBounces", stats->wallBounces, false},
+        {"escapes", stats->escapes, false},
+        {"collisions", stats->collisions, false},
+        {"tilesTouched", stats->tilesTouched, false},
+        {"networks", stats->networks, false},
+        {"rooms", stats->rooms, false},
+        {"roomTiles", stats->roomTiles, false},
+        {"corridorTiles", stats->corridorTiles, false},
+        {"longestCorridor", stats->longestCorridor, false},
+        {"floorTiles", stats->floorTiles, false},
+        {"reachableTiles", stats->reachableTiles, false}};
+    int fieldCount = sizeof(fields) / sizeof(fields[0]);
+
+    // The seed is the only value that doesn't fit in a double
+    unsigned long long seed = params.seed;
+    if (format == STATSFORMAT_JSON)
+    {
+        fprintf(file, "{\"seed\":%llu", seed);
+        for (int i = 0; i < fieldCount; i++)
+        {
+            fprintf(file, fields[i].time ? ",\"%s\":%.3f" : ",\"%s\":%.0f", fields[i].name, fields[i].value);
+        }
+        fputs("}\n", file);
+        return;
+    }
+
+    if (header)
+    {
+        fputs("seed", file);
+        for (int i = 0; i < fieldCount; i++)
+        {
+            fprintf(file, ",%s", fields[i].name);
+        }
+        fputc('\n', file);
+    }
+    fprintf(file, "%llu", seed);
+    for (int i = 0; i < fieldCount; i++)
+    {
+        fprintf(file, fields[i].time ? ",%.3f" : ",%.0f", fields[i].value);
+    }
+    fputc('\n', file);
+}
+
+bool ParseGeneratorLogLevel(const char *name, GENERATORLOG *level)
+{
+    for (int i = 0; i < GENERATORLOG_COUNT; i++)
+    {
+        if (strcmp(name, generatorLogNames[i]) == 0)
+        {
+            *level = (GENERATORLOG)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+double GetTimeSeconds(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static bool GenerateRegion(hexMap *map, arena *scratch, generatorParams params, mapChunk *chunk, generatorStats *stats);
+
+// Where a generated tile ends up, straight into a chunk that isn't in a map yet or through SetTile
+static void SetOutputTile(hexMap *map, mapChunk *chunk, hexCoord coord, TILETYPE tile)
+{
+    if (chunk != NULL)
+    {
+        SetChunkTile(chunk, coord, tile);
+    }
+    else
+    {
+        SetTile(map, coord, tile);
+    }
+}
+
+// Sets the tiles within roomRadius of the room to floor, or back to how the trails left them if trailTiles isn't NULL.
+// Tiles outside the generated hexagon are left alone, returns the number of tiles set
+static int CarveRoom(hexMap *map, mapChunk *chunk, const uint8_t *trailTiles, hexCoord origin, hexCoord room, int roomRadius, int mapRadius)
+{
+    // Only the tiles within the room radius are visited, every tile in the hex range around the collision.
+    // For each q the tiles inside both the room and the hexagon are one run of r, which is contiguous in a chunk
+    int tiles = 0;
+    hexDisc disc;
+    StartClippedDisc(&disc, room, roomRadius - 1, mapRadius / 2 - 1);
+    hexCoord first;
+    int count;
+    while (NextDiscRun(&disc, &first, &count))
+    {
+        tiles += count;
+        first = HexCoordAdd(origin, first);
+        if (chunk != NULL)
+        {
+            int index = ChunkTileIndex(first);
+            if (trailTiles != NULL)
+            {
+                memcpy(&chunk->tiles[index], &trailTiles[index], count);
+            }
+            else
+            {
+                memset(&chunk->tiles[index], TILETYPE_FLOOR, count);
+            }
+            continue;
+        }
+        for (int r = 0; r < count; r++)
+        {
+            SetTile(map, (hexCoord){first.q, first.r + r, first.s - r}, TILETYPE_FLOOR);
+        }
+    }
+    return tiles;
+}
+
+static TILETYPE GetOutputTile(hexMap *map, const mapChunk *chunk, hexCoord coord)
+{
+    return chunk != NULL ? (TILETYPE)chunk->tiles[ChunkTileIndex(coord)] : GetTile(map, coord);
+}
+
+// Counts the floor tiles of the generated hexagon and flood fills from the centre to count the ones that can be reached
+static bool ValidateRegion(hexMap *map, const mapChunk *chunk, arena *scratch, const regionLayout *layout,
+    hexCoord origin, int mapRadius, generatorStats *stats)
+{
+    size_t mark = ArenaMark(scratch);
+    int half = mapRadius / 2;
+    uint8_t *seen = ArenaAlloc(scratch, layout->flood.seen);
+    hexCoord *queue = ArenaAlloc(scratch, layout->flood.queue);
+    if (seen == NULL || queue == NULL)
+    {
+        ArenaRelease(scratch, mark);
+        return false;
+    }
+
+    // A run of the hexagon is contiguous in a chunk
+    stats->floorTiles = 0;
+    hexDisc disc;
+    StartDisc(&disc, origin, half);
+    hexCoord coord;
+    int count;
+    while (NextDiscRun(&disc, &coord, &count))
+    {
+        const uint8_t *tiles = chunk != NULL ? &chunk->tiles[ChunkTileIndex(coord)] : NULL;
+        for (int r = 0; r < count; r++)
+        {
+            TILETYPE tile = tiles != NULL ? (TILETYPE)tiles[r] : GetTile(map, (hexCoord){coord.q, coord.r + r, coord.s - r});
+            stats->floorTiles += tile == TILETYPE_FLOOR;
+        }
+    }
+
+    // The fill only goes on from floor tiles, the centre is always floor since the player starts there
+    stats->reachableTiles = 0;
+    hexFlood flood;
+    StartFlood(&flood, origin, half, queue, seen);
+    while (NextFloodTile(&flood, &coord))
+    {
+        if (GetOutputTile(map, chunk, coord) == TILETYPE_FLOOR)
+        {
+            stats->reachableTiles++;
+            SpreadFlood(&flood, coord);
+        }
+    }
+
+    ArenaRelease(scratch, mark);
+    return true;
+}
+
+size_t GeneratorArenaSize(generatorParams params)
+{
+    if (!GeneratorParamsValid(params))
+    {
+        return 0;
+    }
+    // The most that is taken at once, the groups after the kept one follow each other in the order of the phases
+    regionLayout layout = RegionLayout(params);
+    size_t connect = LAYOUT_GROUP_SIZE(layout.connect);
+    size_t interpret = LAYOUT_GROUP_SIZE(layout.rows) + LAYOUT_GROUP_SIZE(layout.flood);
+    size_t afterMerge = LAYOUT_GROUP_SIZE(layout.merge) + (connect > interpret ? connect : interpret);
+    size_t firstPass = LAYOUT_GROUP_SIZE(layout.firstPass);
+    return LAYOUT_GROUP_SIZE(layout.kept) + (firstPass > afterMerge ? firstPass : afterMerge);
+}
+
+bool GenerateMap(hexMap *map, generatorParams params, generatorStats *stats)
+{
+    arena scratch = {0};
+    bool ok = GenerateRegion(map, &scratch, params, NULL, stats);
+    FreeArena(&scratch);
+    return ok;
+}
+
+bool GenerateMapInArena(hexMap *map, arena *scratch, generatorParams params, generatorStats *stats)
+{
+    return GenerateRegion(map, scratch, params, NULL, stats);
+}
+
+// Generates the hexagon into chunk if it isn't NULL, the hexagon has to fit in the chunk then
+static bool GenerateRegion(hexMap *map, arena *scratch, generatorParams params, mapChunk *chunk, generatorStats *stats)
+{
+    generatorStats localStats;
+    if (stats == NULL)
+    {
+        stats = &localStats;
+    }
+    memset(stats, 0, sizeof(generatorStats));
+
+    if (!GeneratorParamsValid(params))
+    {
+        return false;
+    }
+
+    int mapRadius = params.mapRadius;
+    int turnChanceDenominator = params.turnChanceDenominator;
+    int antCount = params.antCount;
+    int roomRadius = params.roomRadius;
+    int threadCount = GeneratorThreadCount(params);
+
+    // Everything the generation needs comes from the arena, what is left from the last generation is thrown away
+    phaseTimer timer = StartPhaseTimer(stats);
+    regionLayout layout = RegionLayout(params);
+    if (!ReserveArena(scratch, GeneratorArenaSize(params)))
+    {
+        return false;
+    }
+    EndPhase(&timer, GENERATORPHASE_RESERVE);
+    antSwarm ants = {
+        .q = ArenaAlloc(scratch, layout.kept.q),
+        .r = ArenaAlloc(scratch, layout.kept.r),
+        .s = ArenaAlloc(scratch, layout.kept.s),
+        .directions = ArenaAlloc(scratch, layout.kept.directions),
+        .alive = ArenaAlloc(scratch, layout.kept.alive),
+        .steps = ArenaAlloc(scratch, layout.kept.steps),
+        .slots = ArenaAlloc(scratch, layout.kept.slots)};
+    // Ants whose trails are connected are in the same set, the root of a set is the ant that connects the network to the centre
+    int *networks = ArenaAlloc(scratch, layout.kept.networks);
+    unsigned char *networkRanks = ArenaAlloc(scratch, layout.kept.networkRanks);
+    hexCoord *rooms = ArenaAlloc(scratch, layout.kept.rooms);
+    trailGrid trails;
+    if (ants.q == NULL || ants.r == NULL || ants.s == NULL || ants.directions == NULL || ants.alive == NULL ||
+        ants.steps == NULL || ants.slots == NULL || networks == NULL || networkRanks == NULL || rooms == NULL ||
+        !CreateTrailGrid(&trails, scratch, mapRadius))
+    {
+        return false;
+    }
+    // Only needed until the networks are joined
+    size_t firstPassMark = ArenaMark(scratch);
+    int *firstPassBuffers = ArenaAlloc(scratch, layout.firstPass.buffers);
+    if (firstPassBuffers == NULL)
+    {
+        return false;
+    }
+    firstPass pass = {
+        .ants = ants,
+        .seed = params.seed,
+        .collidedWith = firstPassBuffers,
+        .antCount = antCount,
+        .trails = &trails,
+        .mapRadius = mapRadius,
+        .turnChanceDenominator = turnChanceDenominator,
+        .logLevel = params.logLevel,
+        .threads = threadCount,
+        .active = firstPassBuffers + antCount,
+        .moved = firstPassBuffers + antCount * 2,
+        .antStripes = firstPassBuffers + antCount * 3,
+        .stripeOffsets = firstPassBuffers + antCount * 4};
+    atomic_init(&pass.barrier.waiting, 0);
+    atomic_init(&pass.barrier.generation, 0);
+    atomic_init(&pass.start, false);
+    atomic_init(&pass.abort, false);
+
+    // Place the ants randomly
+    for (int i = 0; i < antCount; i++)
+    {
+        networks[i] = i;
+        networkRanks[i] = 0;
+        pass.collidedWith[i] = -1;
+
+        int a = mapRadius / 2 - ANT_EDGE_MARGIN;
+        int q = RandomRange(RandomBits(params.seed, RANDOMSTREAM_PLACE, i, 0), -a, a);
+        int r = RandomRange(RandomBits(params.seed, RANDOMSTREAM_PLACE, i, 1), -a - (q * (q < 0)), a - (q * (q > 0)));
+        int direction = RandomRange(RandomBits(params.seed, RANDOMSTREAM_PLACE, i, 2), 0, 5);
+
+        ants.q[i] = q;
+        ants.r[i] = r;
+        ants.s[i] = -q - r;
+        ants.directions[i] = (uint8_t)direction;
+        ants.alive[i] = true;
+        ants.steps[i] = 0;
+        ants.slots[i] = TrailSlot(&trails, (hexCoord){q, r, -q - r});
+        GeneratorLog(params.logLevel, GENERATORLOG_TRACE, "ant %d: q: %d, r: %d, s: %d\n", i, q, r, -q - r);
+    }
+    EndPhase(&timer, GENERATORPHASE_PLACE);
+
+    // First pass of terrain generation
+    RunFirstPass(&pass, stats);
+
+    // Join the networks in index order so the roots don't depend on the order the threads ran in
+    for (int i = 0; i < antCount; i++)
+    {
+        if (pass.collidedWith[i] >= 0)
+        {
+            UnionNetworks(networks, networkRanks, i, pass.collidedWith[i]);
+        }
+    }
+    ArenaRelease(scratch, firstPassMark);
+    EndPhase(&timer, GENERATORPHASE_FIRSTPASS);
+
+    // Second pass of terrain generation
+    // The networks were joined as the ants died, the root ant of each network stands for it. Node 0 is the centre
+    hexCoord *nodes = ArenaAlloc(scratch, layout.merge.nodes);
+    if (nodes == NULL)
+    {
+        return false;
+    }
+    int nodeCount = 1;
+    nodes[0] = (hexCoord){0, 0, 0};
+    for (int i = 0; i < antCount; i++)
+    {
+        if (FindNetwork(networks, i) == i)
+        {
+            nodes[nodeCount++] = (hexCoord){ants.q[i], ants.r[i], ants.s[i]};
+            stats->networks++;
+            GeneratorLog(params.logLevel, GENERATORLOG_TRACE, "network of ant %d\n", i);
+        }
+    }
+    GeneratorLog(params.logLevel, GENERATORLOG_TRACE, "networks: %d\n", stats->networks);
+    EndPhase(&timer, GENERATORPHASE_MERGE);
+
+    // Connect the networks and the centre with corridors along a minimum spanning tree
+    if (!ConnectNetworks(&trails, scratch, &layout, nodes, nodeCount, mapRadius, stats))
+    {
+        return false;
+    }
+    EndPhase(&timer, GENERATORPHASE_CONNECT);
+
+    // Interpret the map a row of trails at a time
+    hexCoord origin = params.origin;
+    int roomCount = 0;
+    int half = mapRadius / 2;
+    uint8_t *rowTiles = ArenaAlloc(scratch, layout.rows.tiles);
+    int *rowRooms = ArenaAlloc(scratch, layout.rows.rooms);
+    if (rowTiles == NULL || rowRooms == NULL)
+    {
+        return false;
+    }
+    for (int q = -half; q <= half; q++)
+    {
+        // All unexplored tiles are walls and the rest floor. All collisions are rooms, they are carved after every tile
+        // has been set so no wall overwrites them. A row of a chunk is contiguous so chunks are written to directly
+        hexCoord start = HexCoordAdd(origin, (hexCoord){q, -half, half - q});
+        uint8_t *tiles = chunk != NULL ? &chunk->tiles[ChunkTileIndex(start)] : rowTiles;
+        int found = ClassifyTrails(trails.centre + q * trails.stride - half, tiles, mapRadius, rowRooms);
+        for (int k = 0; k < found; k++)
+        {
+            int r = rowRooms[k] - half;
+            rooms[roomCount++] = (hexCoord){q, r, -q - r};
+        }
+        if (chunk == NULL)
+        {
+            SetTileRow(map, start, rowTiles, mapRadius);
+        }
+    }
+    // Keep the tiles as the trails left them so the rooms can be carved again with another radius
+    if (chunk != NULL && params.keepTrails)
+    {
+        chunkTrails *kept = malloc(sizeof(chunkTrails) + sizeof(hexCoord) * roomCount);
+        if (kept != NULL)
+        {
+            memcpy(kept->tiles, chunk->tiles, sizeof(kept->tiles));
+            kept->mapRadius = mapRadius;
+            kept->roomRadius = roomRadius;
+            kept->roomCount = roomCount;
+            memcpy(kept->rooms, rooms, sizeof(hexCoord) * roomCount);
+        }
+        free(chunk->trails);
+        chunk->trails = kept;
+    }
+
+    double roomStart = GetTimeSeconds();
+    for (int i = 0; i < roomCount; i++)
+    {
+        stats->roomTiles += CarveRoom(map, chunk, NULL, origin, rooms[i], roomRadius, mapRadius);
+    }
+    stats->rooms = roomCount;
+    stats->roomTime = GetTimeSeconds() - roomStart;
+
+    // Set the player's tile to floor
+    SetOutputTile(map, chunk, origin, TILETYPE_FLOOR);
+    EndPhase(&timer, GENERATORPHASE_INTERPRET);
+
+    if (params.validate && !ValidateRegion(map, chunk, scratch, &layout, origin, mapRadius, stats))
+    {
+        return false;
+    }
+
+    // One line per map so the summaries can be collected from stderr
+    if (params.logLevel >= GENERATORLOG_INFO)
+    {
+        WriteGeneratorStats(stderr, params, stats, STATSFORMAT_JSON, false);
+    }
+    return true;
+}
+
+mapChunk *BuildChunk(int q, int r, generatorParams params)
+{
+    arena scratch = {0};
+    mapChunk *chunk = BuildChunkInArena(&scratch, q, r, params);
+    FreeArena(&scratch);
+    return chunk;
+}
+
+mapChunk *BuildChunkInArena(arena *scratch, int q, int r, generatorParams params)
+{
+    mapChunk *chunk = CreateChunk(q, r);
+    if (chunk == NULL)
+    {
+        return NULL;
+    }
+
+    // The tiles outside the generated hexagon stay walls
+    for (int i = 0; i < CHUNK_SIZE * CHUNK_SIZE; i++)
+    {
+        chunk->tiles[i] = TILETYPE_WALL;
+    }
+
+    hexCoord centre = ChunkCentre(q, r);
+    if (params.mapRadius > CHUNK_SIZE - 1)
+    {
+        params.mapRadius = CHUNK_SIZE - 1;
+    }
+    params.origin = centre;
+    // Every chunk has its own seed so it looks the same no matter when it is generated
+    params.seed = RandomBits(params.seed, RANDOMSTREAM_CHUNK, (uint32_t)q, (uint32_t)r);
+    if (!GenerateRegion(NULL, scratch, params, chunk, NULL))
+    {
+        FreeChunk(chunk);
+        return NULL;
+    }
+
+    // Corridors along q = 0 and r = 0 through the centre of the chunk meet the corridors of the 4 neighbouring chunks.
+    // Every network is connected to the centre so the whole chunk can be reached from them
+    for (int i = -CHUNK_SIZE / 2; i < CHUNK_SIZE / 2; i++)
+    {
+        SetChunkTile(chunk, HexCoordAdd(centre, (hexCoord){i, 0, -i}), TILETYPE_FLOOR);
+        SetChunkTile(chunk, HexCoordAdd(centre, (hexCoord){0, i, -i}), TILETYPE_FLOOR);
+        if (chunk->trails != NULL)
+        {
+            chunk->trails->tiles[ChunkTileIndex(HexCoordAdd(centre, (hexCoord){i, 0, -i}))] = TILETYPE_FLOOR;
+            chunk->trails->tiles[ChunkTileIndex(HexCoordAdd(centre, (hexCoord){0, i, -i}))] = TILETYPE_FLOOR;
+        }
+    }
+
+    chunk->generated = true;
+    return chunk;
+}
+
+static bool GenerateChunkInArena(hexMap *map, arena *scratch, int q, int r, generatorParams params)
+{
+    mapChunk *chunk = GetChunk(map, q, r);
+    if (chunk != NULL && chunk->generated)
+    {
+        return true;
+    }
+
+    chunk = BuildChunkInArena(scratch, q, r, params);
+    if (chunk == NULL || !InsertChunk(map, chunk))
+    {
+        FreeChunk(chunk);
+        return false;
+    }
+    return true;
+}
+
+bool GenerateChunk(hexMap *map, int q, int r, generatorParams params)
+{
+    arena scratch = {0};
+    bool ok = GenerateChunkInArena(map, &scratch, q, r, params);
+    FreeArena(&scratch);
+    return ok;
+}
+
+void GenerateChunksAround(hexMap *map, hexCoord coord, int distance, generatorParams params)
+{
+    // Reserved by the first chunk that is missing and shared by the rest
+    arena scratch = {0};
+    int q, r;
+    CoordToChunk(coord, &q, &r);
+    for (int i = q - distance; i <= q + distance; i++)
+    {
+        for (int j = r - distance; j <= r + distance; j++)
+        {
+            mapChunk *chunk = GetChunk(map, i, j);
+            if (chunk == NULL || !chunk->generated)
+            {
+                GenerateChunkInArena(map, &scratch, i, j, params);
+            }
+        }
+    }
+    FreeArena(&scratch);
+}
+
+int RecarveRooms(mapChunk *chunk, int roomRadius)
+{
+    chunkTrails *trails = chunk->trails;
+    if (trails == NULL)
+    {
+        return -1;
+    }
+
+    // Only the tiles within the larger of the two radii of a room can change, put those back the way the trails left
+    // them first since rooms can overlap and then carve every room with the new radius
+    hexCoord centre = ChunkCentre(chunk->q, chunk->r);
+    int reach = trails->roomRadius > roomRadius ? trails->roomRadius : roomRadius;
+    int tiles = 0;
+    for (int i = 0; i < trails->roomCount; i++)
+    {
+        tiles += CarveRoom(NULL, chunk, trails->tiles, centre, trails->rooms[i], reach, trails->mapRadius);
+    }
+    for (int i = 0; i < trails->roomCount; i++)
+    {
+        tiles += CarveRoom(NULL, chunk, NULL, centre, trails->rooms[i], roomRadius, trails->mapRadius);
+    }
+    trails->roomRadius = roomRadius;
+    return tiles;
+}
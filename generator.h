@@ -0,0 +1,165 @@
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "map.h"
+#include "arena.h"
+
+// The ants of a generation with an array for each field, ant i is entry i of every array. A step only loads the fields
+// it uses and the ants of a thread are next to each other
+typedef struct antSwarm
+{
+    int *q;
+    int *r;
+    int *s;
+    uint8_t *directions;
+    bool *alive;
+    // Steps taken so far, used as the counter for the ant's random numbers
+    int *steps;
+    // Where the ant's tile is in the generator's trail buffer, kept in step with the position
+    int *slots;
+} antSwarm;
+
+// Ants start at least this many tiles from the edge of the hexagon. It doesn't depend on roomRadius so the trails
+// stay the same when only roomRadius changes, rooms close to the edge are cut off by it instead
+#define ANT_EDGE_MARGIN 9
+
+// What a chunk's generator keeps in chunk->trails when params.keepTrails is set, enough to carve the rooms again
+// with another roomRadius without running the ants. The trails are kept as the tiles they turned into
+typedef struct chunkTrails
+{
+    // The chunk's tiles before any room was carved
+    uint8_t tiles[CHUNK_SIZE * CHUNK_SIZE];
+    int mapRadius;
+    // The radius the rooms in the chunk's tiles have now
+    int roomRadius;
+    int roomCount;
+    // Relative to the centre of the chunk
+    hexCoord rooms[];
+} chunkTrails;
+
+// How much the generator writes to stderr, every level includes the ones before it
+typedef enum GENERATORLOG
+{
+    GENERATORLOG_QUIET,
+    // Things that should never happen, like an ant leaving the map
+    GENERATORLOG_WARNING,
+    // A JSON summary of the stats after every generated map or chunk
+    GENERATORLOG_INFO,
+    // Every placement, death and network
+    GENERATORLOG_TRACE,
+    GENERATORLOG_COUNT
+} GENERATORLOG;
+
+extern const char *generatorLogNames[GENERATORLOG_COUNT];
+
+typedef struct generatorParams
+{
+    int mapRadius;
+    // The chance an ant will turn is 1/turnChanceDenominator
+    int turnChanceDenominator;
+    int antCount;
+    int roomRadius;
+    // All randomness in the generator comes from this seed, for chunks it is the world seed
+    uint64_t seed;
+    // Where the centre of the generated region is on the map
+    hexCoord origin;
+    // Threads stepping the ants in the first pass, the map is the same for any number of threads
+    int threads;
+    GENERATORLOG logLevel;
+    // Flood fill from the centre after generating to check that every floor tile can be reached
+    bool validate;
+    // Keep the trails of generated chunks in chunk->trails so RecarveRooms can change their roomRadius later
+    bool keepTrails;
+} generatorParams;
+
+typedef enum GENERATORPHASE
+{
+    // Getting the arena, only slow when it has to be mapped again for a larger map
+    GENERATORPHASE_RESERVE,
+    GENERATORPHASE_PLACE,
+    GENERATORPHASE_FIRSTPASS,
+    GENERATORPHASE_MERGE,
+    GENERATORPHASE_CONNECT,
+    GENERATORPHASE_INTERPRET,
+    GENERATORPHASE_COUNT
+} GENERATORPHASE;
+
+extern const char *generatorPhaseNames[GENERATORPHASE_COUNT];
+
+typedef struct generatorStats
+{
+    // Wall time in seconds spent in each phase
+    double phaseTime[GENERATORPHASE_COUNT];
+    // Steps taken by the ants in the first pass
+    long long stepsWalked;
+    // Steps that would have left the map and turned the ant around instead
+    long long wallBounces;
+    // Ants that left the map anyway, always 0 unless the bounds checks are broken
+    long long escapes;
+    // Ants that died on another ant's trail, every one of them leaves a room
+    long long collisions;
+    // Tiles claimed by an ant's trail
+    long long tilesTouched;
+    int rooms;
+    // Tiles set to floor by the rooms, rooms that overlap count the same tile more than once
+    long long roomTiles;
+    // Part of the interpret phase spent carving rooms
+    double roomTime;
+    int networks;
+    // Walls turned into floor by the corridors between the networks
+    long long corridorTiles;
+    // Walls turned into floor by the longest single corridor
+    int longestCorridor;
+    // Filled in when params.validate is set, every floor tile is reachable from the centre if they are equal
+    long long floorTiles;
+    long long reachableTiles;
+} generatorStats;
+
+typedef enum STATSFORMAT
+{
+    STATSFORMAT_JSON,
+    STATSFORMAT_CSV
+} STATSFORMAT;
+
+generatorParams DefaultGeneratorParams(void);
+// An odd map radius with room for the ants, at least 2 ants and 1 thread, a turn chance above 0 and a room radius of
+// at least 0. Generation fails for anything else
+bool GeneratorParamsValid(generatorParams params);
+// Parameters for generating a single chunk
+generatorParams DefaultChunkParams(void);
+
+// Generates a hexagon of terrain around params.origin from params.seed into the map, stats can be NULL.
+// Nothing is shared between maps so different maps can be generated on different threads at the same time
+bool GenerateMap(hexMap *map, generatorParams params, generatorStats *stats);
+// The same as GenerateMap with the working memory taken from scratch, which is emptied first and grown if it is too
+// small. Keeping the arena between generations means the memory is only reserved once
+bool GenerateMapInArena(hexMap *map, arena *scratch, generatorParams params, generatorStats *stats);
+// The size of the arena a generation with params needs, 0 if the params aren't valid
+size_t GeneratorArenaSize(generatorParams params);
+
+// Generates the terrain of a chunk from the world seed in params.seed without adding it to the map.
+// Doesn't touch the map so it can run on another thread, returns NULL if out of memory
+mapChunk *BuildChunk(int q, int r, generatorParams params);
+mapChunk *BuildChunkInArena(arena *scratch, int q, int r, generatorParams params);
+// Generates the terrain of a chunk from the world seed in params.seed, does nothing if the chunk has already been generated
+bool GenerateChunk(hexMap *map, int q, int r, generatorParams params);
+// Generates all missing chunks within distance chunks of the chunk the coordinate is in
+void GenerateChunksAround(hexMap *map, hexCoord coord, int distance, generatorParams params);
+// Carves the rooms of a chunk generated with keepTrails again with another roomRadius, only the tiles around the rooms
+// are touched. The chunk ends up the same as if it had been generated with that roomRadius.
+// Returns the number of tiles set or -1 if the chunk has no trails, MarkMapChanged is left to the caller if the chunk is in a map
+int RecarveRooms(mapChunk *chunk, int roomRadius);
+
+// Writes the params and stats of one generation as a single JSON object or CSV row followed by a newline.
+// header writes the CSV column names first and is ignored for JSON
+void WriteGeneratorStats(FILE *file, generatorParams params, const generatorStats *stats, STATSFORMAT format, bool header);
+// Finds the log level with the name in generatorLogNames, returns false if there is none
+bool ParseGeneratorLogLevel(const char *name, GENERATORLOG *level);
+
+double GetTimeSeconds(void);
+
+#endif
@@ -0,0 +1,139 @@
+#include <string.h>
+
+#include "hexquery.h"
+
+void StartRing(hexRing *ring, hexCoord centre, int radius)
+{
+    StartRingAtSide(ring, centre, radius, 0);
+}
+
+void StartRingAtSide(hexRing *ring, hexCoord centre, int radius, int side)
+{
+    hexCoord corner = directionToCoords[side];
+    ring->coord = (hexCoord){centre.q + corner.q * radius, centre.r + corner.r * radius, centre.s + corner.s * radius};
+    ring->radius = radius;
+    ring->firstSide = side;
+    ring->side = 0;
+    ring->step = 0;
+}
+
+void StartSpiral(hexSpiral *spiral, hexCoord centre, int radius)
+{
+    StartRing(&spiral->ring, centre, 0);
+    spiral->centre = centre;
+    spiral->radius = radius;
+}
+
+bool NextSpiralTile(hexSpiral *spiral, hexCoord *coord)
+{
+    while (!NextRingTile(&spiral->ring, coord))
+    {
+        if (spiral->ring.radius >= spiral->radius)
+        {
+            return false;
+        }
+        StartRing(&spiral->ring, spiral->centre, spiral->ring.radius + 1);
+    }
+    return true;
+}
+
+void StartDisc(hexDisc *disc, hexCoord centre, int radius)
+{
+    *disc = (hexDisc){.centre = centre, .radius = radius, .dq = -radius};
+}
+
+void StartClippedDisc(hexDisc *disc, hexCoord centre, int radius, int limit)
+{
+    StartDisc(disc, centre, radius);
+    disc->limit = limit;
+    disc->clipped = true;
+}
+
+bool NextDiscRun(hexDisc *disc, hexCoord *first, int *count)
+{
+    int n = disc->radius;
+    int limit = disc->limit;
+    for (; disc->dq <= n; disc->dq++)
+    {
+        int dq = disc->dq;
+        int q = disc->centre.q + dq;
+        int minR = disc->centre.r + (dq < 0 ? -n - dq : -n);
+        int maxR = disc->centre.r + (dq > 0 ? n - dq : n);
+        if (disc->clipped)
+        {
+            if (abs(q) > limit)
+            {
+                continue;
+            }
+            // Keeps |r| and |s| within the limit too
+            minR = minR > -limit ? minR : -limit;
+            minR = minR > -limit - q ? minR : -limit - q;
+            maxR = maxR < limit ? maxR : limit;
+            maxR = maxR < limit - q ? maxR : limit - q;
+        }
+        if (minR > maxR)
+        {
+            continue;
+        }
+        *first = (hexCoord){q, minR, -q - minR};
+        *count = maxR - minR + 1;
+        disc->dq++;
+        return true;
+    }
+    return false;
+}
+
+void StartLine(hexLine *line, hexCoord from, hexCoord to)
+{
+    *line = (hexLine){
+        .length = HexDistance(from, to),
+        .q = from.q,
+        .r = from.r,
+        .s = from.s,
+        .dq = to.q - from.q,
+        .dr = to.r - from.r,
+        .ds = to.s - from.s};
+}
+
+int HexFloodSeenSize(int radius)
+{
+    return (2 * radius + 1) * (2 * radius + 1);
+}
+
+static uint8_t *FloodSeen(hexFlood *flood, hexCoord coord)
+{
+    int side = 2 * flood->radius + 1;
+    return &flood->seen[(coord.q - flood->centre.q + flood->radius) * side + coord.r - flood->centre.r + flood->radius];
+}
+
+void StartFlood(hexFlood *flood, hexCoord centre, int radius, hexCoord *queue, uint8_t *seen)
+{
+    *flood = (hexFlood){.centre = centre, .radius = radius, .queue = queue, .seen = seen};
+    memset(seen, 0, HexFloodSeenSize(radius));
+    *FloodSeen(flood, centre) = true;
+    flood->queue[flood->tail++] = centre;
+}
+
+bool NextFloodTile(hexFlood *flood, hexCoord *coord)
+{
+    if (flood->head == flood->tail)
+    {
+        return false;
+    }
+    *coord = flood->queue[flood->head++];
+    return true;
+}
+
+void SpreadFlood(hexFlood *flood, hexCoord coord)
+{
+    for (int d = 0; d < 6; d++)
+    {
+        hexCoord next = HexCoordAdd(coord, directionToCoords[d]);
+        if (HexDistance(next, flood->centre) > flood->radius || *FloodSeen(flood, next))
+        {
+            continue;
+        }
+        *FloodSeen(flood, next) = true;
+        flood->queue[flood->tail++] = next;
+    }
+}
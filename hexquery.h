@@ -0,0 +1,209 @@
+#ifndef HEXQUERY_H
+#define HEXQUERY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "map.h"
+
+// Iterators over the tiles around a coordinate. None of them allocate, they are started on a struct on the caller's
+// stack and return one tile per call until they return false. The flood fill takes its queue and seen flags from the
+// caller
+
+static inline int HexDistance(hexCoord a, hexCoord b)
+{
+    return (abs(a.q - b.q) + abs(a.r - b.r) + abs(a.s - b.s)) / 2;
+}
+
+// True if the tile is within radius of 0, 0, 0, the test for being inside a generated hexagon
+static inline bool InHexagon(hexCoord coord, int radius)
+{
+    return abs(coord.q) <= radius && abs(coord.r) <= radius && abs(coord.s) <= radius;
+}
+
+// Tiles within radius of a tile, the tile itself included
+static inline int HexTileCount(int radius)
+{
+    return 3 * radius * (radius + 1) + 1;
+}
+
+// The tiles at exactly radius from the centre. Side k starts at radius times directionToCoords[k] and walks towards
+// the next corner, which is the row a field of view triangle is cast along
+typedef struct hexRing
+{
+    hexCoord coord;
+    int radius;
+    int firstSide;
+    // Sides finished and steps taken along the current one
+    int side;
+    int step;
+} hexRing;
+
+void StartRing(hexRing *ring, hexCoord centre, int radius);
+// The same ring starting at the corner of another side, the sides after it come in order
+void StartRingAtSide(hexRing *ring, hexCoord centre, int radius, int side);
+
+// Inline since it is called for every tile, the field of view walks its rows with it
+static inline bool NextRingTile(hexRing *ring, hexCoord *coord)
+{
+    if (ring->side == 6)
+    {
+        return false;
+    }
+    *coord = ring->coord;
+    // A ring of radius 0 is only the centre
+    if (ring->radius == 0)
+    {
+        ring->side = 6;
+        return true;
+    }
+    ring->coord = HexCoordAdd(ring->coord, directionToCoords[(ring->firstSide + ring->side + 2) % 6]);
+    if (++ring->step == ring->radius)
+    {
+        ring->step = 0;
+        ring->side++;
+    }
+    return true;
+}
+
+// The centre and then every ring out to radius, so the tiles come closest first. Only the query benchmark uses it,
+// the chunk streaming walks a square of chunks that a spiral would leave the corners of
+typedef struct hexSpiral
+{
+    hexRing ring;
+    hexCoord centre;
+    int radius;
+} hexSpiral;
+
+void StartSpiral(hexSpiral *spiral, hexCoord centre, int radius);
+bool NextSpiralTile(hexSpiral *spiral, hexCoord *coord);
+
+// The tiles within radius of the centre by q and then r. The tiles of one q are a run in the +r direction, which is
+// contiguous in a chunk and in the generator's trails, so the disc can also be walked a run at a time
+typedef struct hexDisc
+{
+    hexCoord centre;
+    int radius;
+    // Tiles further than limit from 0, 0, 0 are left out, to keep the disc inside a generated hexagon
+    int limit;
+    bool clipped;
+    // The offset of the next run from the centre's q
+    int dq;
+    // The next tile of the current run and the tiles left in it
+    hexCoord next;
+    int left;
+} hexDisc;
+
+void StartDisc(hexDisc *disc, hexCoord centre, int radius);
+void StartClippedDisc(hexDisc *disc, hexCoord centre, int radius, int limit);
+// The first tile and the length of the next run that isn't empty
+bool NextDiscRun(hexDisc *disc, hexCoord *first, int *count);
+
+// Inline since it is called for every tile and usually only steps along the run
+static inline bool NextDiscTile(hexDisc *disc, hexCoord *coord)
+{
+    if (disc->left == 0 && !NextDiscRun(disc, &disc->next, &disc->left))
+    {
+        return false;
+    }
+    *coord = disc->next;
+    disc->next.r++;
+    disc->next.s--;
+    disc->left--;
+    return true;
+}
+
+// The tiles on the straight line from one tile to another, both included, the tiles the line's centre passes through.
+// Stepped with integers like Bresenham's line, so it is the same on every machine and a line along one of the six
+// directions visits exactly the tiles of that row. Halfway cases go towards +q, +r and +s. The generator carves a
+// corridor along it when the corridor search runs out of room
+typedef struct hexLine
+{
+    int length;
+    int step;
+    // Every component is kept as a whole part and a remainder in 1 / length
+    int q, r, s;
+    int qRemainder, rRemainder, sRemainder;
+    int dq, dr, ds;
+} hexLine;
+
+void StartLine(hexLine *line, hexCoord from, hexCoord to);
+
+// Adds the step of one component, no component moves by more than the length so the whole part changes by at most 1
+static inline void StepLineComponent(int *whole, int *remainder, int delta, int length)
+{
+    *remainder += delta;
+    if (*remainder >= length)
+    {
+        *remainder -= length;
+        (*whole)++;
+    }
+    else if (*remainder < 0)
+    {
+        *remainder += length;
+        (*whole)--;
+    }
+}
+
+static inline bool NextLineTile(hexLine *line, hexCoord *coord)
+{
+    if (line->step > line->length)
+    {
+        return false;
+    }
+    int n = line->length;
+    // Every component rounded to the closest whole number, the error is in 1 / length
+    bool qUp = line->qRemainder * 2 >= n && n > 0;
+    bool rUp = line->rRemainder * 2 >= n && n > 0;
+    bool sUp = line->sRemainder * 2 >= n && n > 0;
+    hexCoord rounded = {line->q + qUp, line->r + rUp, line->s + sUp};
+    int qError = qUp ? n - line->qRemainder : line->qRemainder;
+    int rError = rUp ? n - line->rRemainder : line->rRemainder;
+    int sError = sUp ? n - line->sRemainder : line->sRemainder;
+    // Rounding can leave q + r + s off by one, the component that was rounded the furthest is made to fit
+    if (qError > rError && qError > sError)
+    {
+        rounded.q = -rounded.r - rounded.s;
+    }
+    else if (rError > sError)
+    {
+        rounded.r = -rounded.q - rounded.s;
+    }
+    else
+    {
+        rounded.s = -rounded.q - rounded.r;
+    }
+    *coord = rounded;
+
+    if (++line->step <= n)
+    {
+        StepLineComponent(&line->q, &line->qRemainder, line->dq, n);
+        StepLineComponent(&line->r, &line->rRemainder, line->dr, n);
+        StepLineComponent(&line->s, &line->sRemainder, line->ds, n);
+    }
+    return true;
+}
+
+// A breadth first fill outwards from the centre within radius of it. Every tile the fill reaches is returned once and
+// the caller decides if the fill goes on from it with SpreadFlood, so what blocks the fill stays up to the caller
+typedef struct hexFlood
+{
+    hexCoord centre;
+    int radius;
+    // Room for HexTileCount(radius) tiles
+    hexCoord *queue;
+    int head;
+    int tail;
+    // HexFloodSeenSize(radius) bytes, a row per q like the trails
+    uint8_t *seen;
+} hexFlood;
+
+int HexFloodSeenSize(int radius);
+// Clears seen and queues the centre
+void StartFlood(hexFlood *flood, hexCoord centre, int radius, hexCoord *queue, uint8_t *seen);
+bool NextFloodTile(hexFlood *flood, hexCoord *coord);
+// Queues the neighbours of a tile the fill has reached that it hasn't queued yet
+void SpreadFlood(hexFlood *flood, hexCoord coord);
+
+#endif
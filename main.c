@@ -1,444 +1,313 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
 #include <math.h>
 
 #include "raylib.h"
 #include "raymath.h"
 
-typedef enum TILETYPE
-{
-    TILETYPE_NONE,
-    TILETYPE_FLOOR,
-    TILETYPE_WALL,
-    TILETYPE_HOLE
-} TILETYPE;
-
-typedef struct hexCoord
-{
-    int q;
-    int r;
-    int s;
-} hexCoord;
-
-const int startMapRadius = 101; // Must be odd
-TILETYPE map[startMapRadius * 2][startMapRadius * 2];
-int mapRadius = startMapRadius;
-float tileRadius = 80;
-Vector2 cameraPos = (Vector2){0, 0};
-
-TILETYPE GetTile(hexCoord coord)
-{
-    return map[abs(coord.q * 2) - (coord.q > 0)][abs(coord.r * 2) - (coord.r > 0)];
-}
-
-void SetTile(hexCoord coord, TILETYPE tile)
-{
-    map[abs(coord.q * 2) - (coord.q > 0)][abs(coord.r * 2) - (coord.r > 0)] = tile;
-}
+#include "map.h"
+#include "generator.h"
+#include "render.h"
+#include "stream.h"
+#include "snapshot.h"
+#include "profiler.h"
+#include "sim.h"
 
-Vector2 HexCoordToVector(hexCoord coord)
+// The movement keys that are down, q, w, e, a, s, d because of the hex grid
+static tickInput ReadMovementKeys(void)
 {
-    float x = tileRadius * 1.5 * coord.q;
-    float y = (coord.s - coord.r) * sqrt(3) * tileRadius * 0.5;
-    return (Vector2){x, y};
+    const int keys[6] = {KEY_S, KEY_D, KEY_E, KEY_W, KEY_Q, KEY_A};
+    tickInput input = 0;
+    for (int d = 0; d < 6; d++)
+    {
+        input |= IsKeyDown(keys[d]) << d;
+    }
+    return input;
 }
 
-Vector2 HexCoordToCameraVector(hexCoord coord)
+// Regenerates the world with new generator parameters. When only roomRadius changed the rooms of every chunk are
+// carved again from the kept trails, otherwise the map is thrown away and the streamer generates it again
+static void RetuneWorld(chunkStreamer *streamer, generatorParams old, generatorParams params)
 {
-    float x = tileRadius * 1.5 * coord.q + cameraPos.x;
-    float y = (coord.s - coord.r) * sqrt(3) * tileRadius * 0.5 + cameraPos.y;
-    return (Vector2){x, y};
-}
+    hexMap *map = streamer->map;
+    SetChunkStreamerParams(streamer, params);
+    int count = MapChunkCount(map);
+    mapChunk **chunks = malloc(sizeof(mapChunk *) * (count + 1));
+    if (chunks == NULL || old.turnChanceDenominator != params.turnChanceDenominator || old.antCount != params.antCount)
+    {
+        free(chunks);
+        ClearMap(map);
+        return;
+    }
 
-hexCoord IndexToHexCoord(int q, int r)
-{
-    q = (q % 2 == 0 ? -q : q + 1) / 2;
-    r = (r % 2 == 0 ? -r : r + 1) / 2;
-    return (hexCoord){q, r, -q - r};
+    CollectChunks(map, chunks);
+    for (int i = 0; i < count; i++)
+    {
+        // Chunks loaded from a snapshot have no trails and are generated again
+        if (RecarveRooms(chunks[i], params.roomRadius) < 0)
+        {
+            mapChunk *chunk = BuildChunk(chunks[i]->q, chunks[i]->r, params);
+            if (chunk != NULL && !InsertChunk(map, chunk))
+            {
+                FreeChunk(chunk);
+            }
+        }
+    }
+    free(chunks);
+    // The recarved chunks changed in place, the field of view has to be cast again
+    MarkMapChanged(map);
 }
 
-hexCoord HexCoordAdd(hexCoord a, hexCoord b)
+// True if both params generate the same chunks
+static bool SameWorldParams(generatorParams a, generatorParams b)
 {
-    return (hexCoord){a.q + b.q, a.r + b.r, a.s + b.s};
+    return a.seed == b.seed && a.mapRadius == b.mapRadius && a.turnChanceDenominator == b.turnChanceDenominator &&
+        a.antCount == b.antCount && a.roomRadius == b.roomRadius;
 }
 
-typedef struct ant
+int main(int argc, char **argv)
 {
-    hexCoord position;
-    int direction;
-    bool alive;
-} ant;
-
-int main()
-{
-    const int screenWidth = GetScreenWidth();
-    const int screenHeight = GetScreenHeight();
-    InitWindow(screenWidth, screenHeight, "endless dungeon");
-    ToggleFullscreen();
-
-    float moveSpeed = 500;
-
-    Color tileColors[4] = {
-        (Color){0, 0, 0, 0},
-        (Color){220, 200, 50, 255},
-        (Color){100, 80, 0, 255},
-        (Color){100, 100, 255, 255}};
-
-    const hexCoord directionToCoords[6] = {
-        (hexCoord){0, -1, 1},
-        (hexCoord){1, -1, 0},
-        (hexCoord){1, 0, -1},
-        (hexCoord){0, 1, -1},
-        (hexCoord){-1, 1, 0},
-        (hexCoord){-1, 0, 1}};
-
-    // There are probably way better things to seed from
-    SetRandomSeed((int)(&moveSpeed));
-    // The chance an ant will turn is 1/turnChanceDenominator
-    int turnChanceDenominator = 3;
-    int antCount = 60;
-    int aliveAnts = antCount;
-    int roomRadius = 4;
-    ant ants[antCount];
-    // The index that an ant collides with is stored here
-    int collisions[antCount];
-    // Place the ants randomly
-    for (int i = 0; i < antCount; i++)
-    {
-        int a = ((mapRadius / 2) - roomRadius - 5);
-        int q = GetRandomValue(-a, a);
-        int r = GetRandomValue(-a - (q * (q < 0)), a - (q * (q > 0)));
-
-        ants[i] = (ant){(hexCoord){q, r, -q - r}, GetRandomValue(0, 5), true};
-        printf("ant %d: q: %d, r: %d, s: %d\n", i, ants[i].position.q, ants[i].position.r, ants[i].position.s);
-    }
-
-    // Set all tiles to -1 to indicate that no ant has been there
-    for (int i = 0; i < mapRadius * 2; i++)
+    double startTime = GetTimeSeconds();
+    // A seed can be given with --seed to get the same world again, --load starts from a saved world and --save
+    // writes the world to a file when the game closes. --log sets how much the generator writes to stderr and
+    // --capture where F4 writes the profiler's frames. --record writes the movement keys of every tick to a file and
+    // --replay plays such a file back in the world it was recorded in
+    uint64_t worldSeed = (uint64_t)time(NULL);
+    const char *recordPath = NULL;
+    const char *replayPath = NULL;
+    const char *capturePath = "frames.csv";
+    GENERATORLOG logLevel = GENERATORLOG_WARNING;
+    const char *loadPath = NULL;
+    const char *savePath = NULL;
+    for (int i = 1; i + 1 < argc; i++)
     {
-        for (int j = 0; j < mapRadius * 2; j++)
+        if (strcmp(argv[i], "--seed") == 0)
         {
-            SetTile(IndexToHexCoord(i, j), -1);
+            worldSeed = strtoull(argv[++i], NULL, 10);
         }
-    }
-
-    // First pass of terrain generation
-    while (aliveAnts > 0)
-    {
-        for (int i = 0; i < antCount; i++)
+        else if (strcmp(argv[i], "--load") == 0)
         {
-            if (ants[i].alive)
-            {
-                // Determine if the ant should turn
-                if (GetRandomValue(0, turnChanceDenominator) == 0)
-                {
-                    ants[i].direction += (GetRandomValue(0, 1) == 0 ? -1 : 1);
-                }
-                ants[i].direction %= 6;
-
-                // Move the ant
-                ants[i].position = HexCoordAdd(ants[i].position, directionToCoords[ants[i].direction]);
-
-                // If the ant is out of bounds, turn around
-                if (
-                    abs(ants[i].position.q) > mapRadius / 2 - 1 ||
-                    abs(ants[i].position.r) > mapRadius / 2 - 1 ||
-                    abs(ants[i].position.s) > mapRadius / 2 - 1)
-                {
-                    ants[i].position.q -= directionToCoords[ants[i].direction].q;
-                    ants[i].position.r -= directionToCoords[ants[i].direction].r;
-                    ants[i].position.s -= directionToCoords[ants[i].direction].s;
-                    ants[i].direction = (ants[i].direction + 3) % 6;
-                }
-
-                // If the rest of the code works this should be redundant but the the issue could be hard to find without these console messages
-                // FIX HERE
-                if (abs(ants[i].position.q) > mapRadius / 2)
-                {
-                    ants[i].alive = false;
-                    printf("ant escaped q%d\n", ants[i].position.q);
-                    continue;
-                }
-                if (abs(ants[i].position.r) > mapRadius / 2)
-                {
-                    ants[i].alive = false;
-                    printf("ant escaped r%d\n", ants[i].position.r);
-                    continue;
-                }
-                if (abs(ants[i].position.s) > mapRadius / 2)
-                {
-                    ants[i].alive = false;
-                    printf("ant escaped s%d\n", ants[i].position.s);
-                    continue;
-                }
-
-                switch (GetTile(ants[i].position))
-                {
-                case -1:
-                {
-                    // If the ant is on an unexplored tile, set the tile to the ant's index
-                    SetTile(ants[i].position, i);
-                }
-                break;
-                default:
-                {
-                    if (GetTile(ants[i].position) != i)
-                    {
-                        // If the ant is on a tile that has been explored by another ant, kill the ant, track the collision and set the tile to -2 for a room to be created later
-                        ants[i].alive = false;
-                        puts("ant died");
-                        collisions[i] = GetTile(ants[i].position);
-                        SetTile(ants[i].position, -2);
-                    }
-                }
-                break;
-                }
-            }
+            loadPath = argv[++i];
         }
-
-        aliveAnts = 0;
-        for (int i = 0; i < antCount; i++)
+        else if (strcmp(argv[i], "--save") == 0)
+        {
+            savePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--capture") == 0)
+        {
+            capturePath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--record") == 0)
         {
-            aliveAnts += ants[i].alive;
+            recordPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--replay") == 0)
+        {
+            replayPath = argv[++i];
+        }
+        else if (strcmp(argv[i], "--log") == 0 && !ParseGeneratorLogLevel(argv[++i], &logLevel))
+        {
+            printf("unknown log level %s\n", argv[i]);
+            return 1;
         }
     }
 
-    for (int i = 0; i < antCount; i++)
-    {
-        printf("%d ", collisions[i]);
-    }
-    printf("\n");
+    generatorParams params = DefaultChunkParams();
+    params.seed = worldSeed;
+    params.logLevel = logLevel;
+    // The trails are kept so the room radius can be tuned while playing without running the ants again
+    params.keepTrails = true;
 
-    // Second pass of terrain generation
-    // Calculate the amount of separated networks of ant trails by replacing the value of each collision with the value at the index the value points to
-    for (int i = 0; i < antCount; i++)
+    hexMap map = {0};
+    snapshot loaded = {0};
+    if (loadPath != NULL)
     {
-        for (int j = 0; j < antCount; j++)
+        if (!LoadSnapshot(&map, loadPath, &loaded))
         {
-            if (collisions[j] == i)
-            {
-                collisions[j] = collisions[i];
-            }
+            printf("failed to load %s\n", loadPath);
+            return 1;
         }
+        // New chunks have to come from the same params to fit the saved ones
+        params = SnapshotParams(&loaded, params);
     }
-
-    // Reanimate one ant from each network
-    for (int i = 0; i < antCount; i++)
+    // A replay only makes sense in the world it was recorded in
+    inputReplay replay = {0};
+    bool replaying = replayPath != NULL;
+    if (replaying)
     {
-        ants[collisions[i]].alive = true;
+        if (!OpenReplay(&replay, replayPath))
+        {
+            printf("failed to open %s\n", replayPath);
+            return 1;
+        }
+        generatorParams recorded = ReplayParams(&replay, params);
+        if (loadPath != NULL && !SameWorldParams(recorded, params))
+        {
+            printf("%s was recorded in another world than %s\n", replayPath, loadPath);
+            return 1;
+        }
+        params = recorded;
     }
+    printf("seed: %llu\n", (unsigned long long)params.seed);
 
-    aliveAnts = 0;
-    for (int i = 0; i < antCount; i++)
-    {
-        aliveAnts += ants[i].alive;
-    }
-    printf("aliveAnts: %d\n", aliveAnts);
+    const int screenWidth = GetScreenWidth();
+    const int screenHeight = GetScreenHeight();
+    InitWindow(screenWidth, screenHeight, "endless dungeon");
+    ToggleFullscreen();
 
-    // Set all non relevant collisions to -1 to avoid double updating an ant. This shouldn't be neccesary with the chosen method of connecting networks
-    // FIX HERE
-    for (int i = 0; i < antCount; i++)
+    float moveSpeed = 500;
+    renderView view;
+    InitRenderView(&view);
+
+    inputRecorder recorder = {0};
+    if (recordPath != NULL && !StartRecording(&recorder, recordPath, params))
     {
-        for (int j = i + 1; j < antCount; j++)
-        {
-            if (collisions[j] == collisions[i] && collisions[j] >= 0)
-            {
-                collisions[j] = -collisions[j];
-            }
-        }
+        printf("failed to write %s\n", recordPath);
+        CloseWindow();
+        return 1;
     }
-
-    for (int i = 0; i < antCount; i++)
+    // How long the last change of the generator parameters took, negative before the first change
+    double retuneTime = -1;
+    // The chunks around the player are generated on another thread before they can come into view,
+    // the spawn chunk comes first so the player can move while the rest finishes
+    int chunkDistance = 1;
+    chunkStreamer streamer;
+    if (!StartChunkStreamer(&streamer, &map, params))
     {
-        if (collisions[i] >= 0)
-        {
-            printf("%d ", collisions[i]);
-        }
+        puts("failed to start the generator thread");
+        CloseWindow();
+        return 1;
     }
-    printf("\n");
-
-    // Move all alive ants to the center of the map
-    for (int i = 0; i < antCount; i++)
+    StreamChunksAround(&streamer, (hexCoord){0, 0, 0}, chunkDistance);
+    // Time from starting the game until the first frame where the player can move, negative until then
+    double timeToInteractive = -1;
+
+    // The player moves in fixed ticks, the time of the frames is added up and as many ticks run as fit in it
+    gameState game;
+    InitGameState(&game);
+    double tickTime = 0;
+    visibleTiles visible = {0};
+    // The player sees the tiles less than visionRadius away that aren't hidden behind walls
+    int visionRadius = 7;
+    fovCache fov;
+    if (!InitFovCache(&fov, visionRadius - 1))
     {
-        if (collisions[i] >= 0)
-        {
-            ant a = ants[collisions[i]];
-            while (a.alive)
-            {
-                printf("updating ant %d ", collisions[i]);
-                if (a.position.q != 0 && a.position.r != 0)
-                {
-                    // Finding the way towards the center of the map
-                    hexCoord b = (hexCoord){
-                        a.position.q > 0 ? -1 : 1,
-                        a.position.r > 0 ? -1 : 1,
-                        a.position.s > 0 ? -1 : 1};
-                    if (abs(a.position.q) < abs(a.position.r))
-                    {
-                        if (abs(a.position.q) < abs(a.position.s))
-                        {
-                            b.q = 0;
-                        }
-                        else
-                        {
-                            b.s = 0;
-                        }
-                    }
-                    else
-                    {
-                        if (abs(a.position.r) < abs(a.position.s))
-                        {
-                            b.r = 0;
-                        }
-                        else
-                        {
-                            b.s = 0;
-                        }
-                    }
-                    a.position = HexCoordAdd(a.position, b);
-                    printf("q: %d, r: %d, s: %d\n", a.position.q, a.position.r, a.position.s);
-
-                    if (GetTile(a.position) == -1)
-                    {
-                        SetTile(a.position, collisions[i]);
-                    }
-                }
-                else
-                {
-                    a.alive = false;
-                }
-            }
-        }
+        puts("out of memory");
+        StopChunkStreamer(&streamer);
+        CloseWindow();
+        return 1;
     }
-    puts("done");
-
-    // Interpret the map
-    for (int i = 0; i < mapRadius; i++)
+    // F3 shows where the time of a frame goes, F4 writes the last frames to capturePath
+    frameProfiler profiler;
+    if (!InitFrameProfiler(&profiler, PROFILER_FRAMES))
     {
-        for (int j = 0; j < mapRadius; j++)
-        {
-            switch (GetTile(IndexToHexCoord(i, j)))
-            {
-            case -1:
-                // All unexplored tiles are walls
-                SetTile(IndexToHexCoord(i, j), TILETYPE_WALL);
-                break;
-            case -2:
-            {
-                // All collisions are rooms
-                // Room for optimization here by only accessing the tiles that are within the room radius
-                hexCoord a = IndexToHexCoord(i, j);
-                for (int k = 0; k < mapRadius; k++)
-                {
-                    for (int l = 0; l < mapRadius; l++)
-                    {
-                        hexCoord b = IndexToHexCoord(k, l);
-                        if (
-                            abs(a.q - b.q) < roomRadius &&
-                            abs(a.r - b.r) < roomRadius &&
-                            abs(a.s - b.s) < roomRadius &&
-                            abs(b.q) < mapRadius / 2 &&
-                            abs(b.r) < mapRadius / 2 &&
-                            abs(b.s) < mapRadius / 2)
-                        {
-                            SetTile(b, TILETYPE_FLOOR);
-                        }
-                    }
-                }
-
-                // SetTile(IndexToHexCoord(i, j), TILETYPE_HOLE);
-            }
-            break;
-            default:
-                SetTile(IndexToHexCoord(i, j), TILETYPE_FLOOR);
-                break;
-            }
-        }
+        puts("out of memory");
+        FreeFovCache(&fov);
+        StopChunkStreamer(&streamer);
+        CloseWindow();
+        return 1;
     }
-    // Set the player's tile to floor
-    SetTile((hexCoord){0, 0, 0}, TILETYPE_FLOOR);
-
-    hexCoord player = (hexCoord){0, 0, 0};
-    hexCoord oldPlayer = (hexCoord){0, 0, 0};
-    // 1 means the player is at the new position, 0 means the player is at the old position
-    float moveLerp = 1;
 
     while (!WindowShouldClose())
     {
+        BeginProfiledFrame(&profiler);
+
         // -----
         // Input
         // -----
         if (IsKeyDown(KEY_UP))
         {
-            cameraPos.y += moveSpeed * GetFrameTime();
+            view.cameraPos.y += moveSpeed * GetFrameTime();
         }
         if (IsKeyDown(KEY_DOWN))
         {
-            cameraPos.y -= moveSpeed * GetFrameTime();
+            view.cameraPos.y -= moveSpeed * GetFrameTime();
         }
         if (IsKeyDown(KEY_LEFT))
         {
-            cameraPos.x += moveSpeed * GetFrameTime();
+            view.cameraPos.x += moveSpeed * GetFrameTime();
         }
         if (IsKeyDown(KEY_RIGHT))
         {
-            cameraPos.x -= moveSpeed * GetFrameTime();
+            view.cameraPos.x -= moveSpeed * GetFrameTime();
         }
         if (IsKeyDown(KEY_U))
         {
-            tileRadius *= 1 + GetFrameTime();
+            view.tileRadius *= 1 + GetFrameTime();
         }
         if (IsKeyDown(KEY_J))
         {
-            tileRadius *= 1 - GetFrameTime();
+            view.tileRadius *= 1 - GetFrameTime();
         }
-
-        if (moveLerp >= 1)
+        if (IsKeyPressed(KEY_F3))
         {
-            if (IsKeyDown(KEY_S) &&
-                GetTile(HexCoordAdd(player, directionToCoords[0])) != TILETYPE_WALL)
-            {
-                oldPlayer = player;
-                player = HexCoordAdd(player, directionToCoords[0]);
-                moveLerp = 0;
-            }
-            if (IsKeyDown(KEY_D) &&
-                GetTile(HexCoordAdd(player, directionToCoords[1])) != TILETYPE_WALL)
-            {
-                oldPlayer = player;
-                player = HexCoordAdd(player, directionToCoords[1]);
-                moveLerp = 0;
-            }
-            if (IsKeyDown(KEY_E) &&
-                GetTile(HexCoordAdd(player, directionToCoords[2])) != TILETYPE_WALL)
+            profiler.showOverlay = !profiler.showOverlay;
+        }
+        if (IsKeyPressed(KEY_F4))
+        {
+            if (WriteFrameCapture(&profiler, capturePath))
             {
-                oldPlayer = player;
-                player = HexCoordAdd(player, directionToCoords[2]);
-                moveLerp = 0;
+                printf("wrote %d frames to %s\n", profiler.count, capturePath);
             }
-            if (IsKeyDown(KEY_W) &&
-                GetTile(HexCoordAdd(player, directionToCoords[3])) != TILETYPE_WALL)
+            else
             {
-                oldPlayer = player;
-                player = HexCoordAdd(player, directionToCoords[3]);
-                moveLerp = 0;
+                printf("failed to write %s\n", capturePath);
             }
-            if (IsKeyDown(KEY_Q) &&
-                GetTile(HexCoordAdd(player, directionToCoords[4])) != TILETYPE_WALL)
+        }
+
+        // Live tuning of the generator, 1/2 changes the turn chance, 3/4 the ant count and 5/6 the room radius.
+        // The recording only has the params the world started with, so tuning is off while recording or replaying
+        generatorParams tuned = params;
+        tuned.turnChanceDenominator += IsKeyPressed(KEY_TWO) - IsKeyPressed(KEY_ONE);
+        tuned.antCount += (IsKeyPressed(KEY_FOUR) - IsKeyPressed(KEY_THREE)) * 5;
+        tuned.roomRadius += IsKeyPressed(KEY_SIX) - IsKeyPressed(KEY_FIVE);
+        if (recorder.file == NULL && !replaying &&
+            tuned.turnChanceDenominator >= 1 && tuned.antCount >= 2 &&
+            tuned.roomRadius >= 1 && tuned.roomRadius <= tuned.mapRadius / 2 &&
+            (tuned.turnChanceDenominator != params.turnChanceDenominator ||
+                tuned.antCount != params.antCount ||
+                tuned.roomRadius != params.roomRadius))
+        {
+            double retuneStart = GetTimeSeconds();
+            RetuneWorld(&streamer, params, tuned);
+            retuneTime = GetTimeSeconds() - retuneStart;
+            params = tuned;
+        }
+
+        // Run the ticks that fit in the time since the last frame, a long frame drops the time that doesn't fit
+        tickInput keys = ReadMovementKeys();
+        tickTime += GetFrameTime();
+        tickTime = tickTime < SIM_TICK_SECONDS * SIM_MAX_TICKS_PER_FRAME ? tickTime : SIM_TICK_SECONDS * SIM_MAX_TICKS_PER_FRAME;
+        // A tick waits until the chunks around the player have arrived from the streamer, so a move never depends on
+        // how fast they were generated and a recording plays back the same way
+        while (tickTime >= SIM_TICK_SECONDS && SurroundingsGenerated(&map, game.player))
+        {
+            tickInput input = keys;
+            if (replaying && !NextReplayInput(&replay, &input))
             {
-                oldPlayer = player;
-                player = HexCoordAdd(player, directionToCoords[4]);
-                moveLerp = 0;
+                // The keyboard takes over where the recording ends
+                replaying = false;
+                input = keys;
+                printf("replay ended after %lld ticks, %s\n", game.tick,
+                    ReplayMatches(&replay, &game) ? "the player ended up where the recording did" : "the player ended up somewhere else");
+                CloseReplay(&replay);
             }
-            if (IsKeyDown(KEY_A) &&
-                GetTile(HexCoordAdd(player, directionToCoords[5])) != TILETYPE_WALL)
+            if (recorder.file != NULL)
             {
-                oldPlayer = player;
-                player = HexCoordAdd(player, directionToCoords[5]);
-                moveLerp = 0;
+                RecordInput(&recorder, input);
             }
+            StepGame(&game, &map, input);
+            tickTime -= SIM_TICK_SECONDS;
         }
+        EndFrameSection(&profiler, FRAMESECTION_INPUT);
+
+        // Pick up the chunks that finished generating and request new ones when the player gets close to the edge of the generated world
+        StreamChunksAround(&streamer, game.player, chunkDistance);
+        EndFrameSection(&profiler, FRAMESECTION_STREAM);
 
         /* for (int i = 0; i < 20; i++)
         {
@@ -451,119 +320,35 @@ int main()
 
         } */
 
-        // Lerp the camera for smother movement
-        if (moveLerp < 1)
-        {
-            moveLerp += GetFrameTime() * 5;
-            cameraPos = Vector2Lerp(
-                Vector2Add(Vector2Scale(HexCoordToVector(oldPlayer), -1),
-                    (Vector2){GetScreenWidth() / 2, GetScreenHeight() / 2}),
-                Vector2Add(Vector2Scale(HexCoordToVector(player), -1),
-                    (Vector2){GetScreenWidth() / 2, GetScreenHeight() / 2}),
-                moveLerp
-            );
-        }
-        else
-        {
-            moveLerp = 1;
-            cameraPos = Vector2Add(Vector2Scale(HexCoordToVector(player), -1),
-                (Vector2){GetScreenWidth() / 2, GetScreenHeight() / 2});
-        }
+        // Lerp the camera for smother movement, the tick moves the player along
+        view.cameraPos = Vector2Lerp(
+            Vector2Add(Vector2Scale(HexCoordToVector(&view, game.oldPlayer), -1),
+                (Vector2){GetScreenWidth() / 2, GetScreenHeight() / 2}),
+            Vector2Add(Vector2Scale(HexCoordToVector(&view, game.player), -1),
+                (Vector2){GetScreenWidth() / 2, GetScreenHeight() / 2}),
+            game.moveLerp
+        );
+        EndFrameSection(&profiler, FRAMESECTION_CAMERA);
+
+        // Find the tiles within the player's vision
+        BuildVisibleTiles(&view, &visible, GetFieldOfView(&fov, &map, game.player));
+        EndFrameSection(&profiler, FRAMESECTION_FOV);
 
         BeginDrawing();
         ClearBackground(BLACK);
+        view.stats = (renderCounters){0};
 
-        // Draw the tiles within the player's vision
-        // Room for optimization here by only accessing the tiles that are within the player's vision
-        int visionRadius = 7;
         // First pass for floor tiles
-        for (int k = 0; k < mapRadius; k++)
-        {
-            for (int l = 0; l < mapRadius; l++)
-            {
-                hexCoord b = IndexToHexCoord(k, l);
-                if (
-                    abs(player.q - b.q) < visionRadius &&
-                    abs(player.r - b.r) < visionRadius &&
-                    abs(player.s - b.s) < visionRadius &&
-                    abs(b.q) <= mapRadius / 2 &&
-                    abs(b.r) <= mapRadius / 2 &&
-                    abs(b.s) <= mapRadius / 2)
-                {
-                    DrawPoly(HexCoordToCameraVector(IndexToHexCoord(k, l)),
-                        6, tileRadius, 30, tileColors[GetTile(IndexToHexCoord(k, l))]);
-                    DrawPolyLines(HexCoordToCameraVector(IndexToHexCoord(k, l)),
-                        6, tileRadius, 30, BLACK);
-                }
-            }
-        }
+        DrawFloorTiles(&view, &visible);
         // Player
-        DrawCircleV(
-            Vector2Lerp(HexCoordToCameraVector(oldPlayer),
-                HexCoordToCameraVector(player), moveLerp),
-            tileRadius * 0.8, (Color){255, 0, 0, 255});
-
+        DrawPlayer(&view, Vector2Lerp(HexCoordToCameraVector(&view, game.oldPlayer), HexCoordToCameraVector(&view, game.player), game.moveLerp));
+        EndFrameSection(&profiler, FRAMESECTION_FLOOR);
         // Second pass for the walls' walls
-        for (int i = 0; i < mapRadius; i++)
-        {
-            for (int j = 0; j < mapRadius; j++)
-            {
-                hexCoord b = IndexToHexCoord(i, j);
-                if (
-                    abs(player.q - b.q) < visionRadius &&
-                    abs(player.r - b.r) < visionRadius &&
-                    abs(player.s - b.s) < visionRadius &&
-                    abs(b.q) <= mapRadius / 2 &&
-                    abs(b.r) <= mapRadius / 2 &&
-                    abs(b.s) <= mapRadius / 2)
-                {
-                    if (GetTile(IndexToHexCoord(i, j)) == TILETYPE_WALL)
-                    {
-                        DrawPoly(
-                            HexCoordToCameraVector(IndexToHexCoord(i, j)),
-                            6, tileRadius, 30, tileColors[TILETYPE_WALL]);
-                        DrawPolyLines(
-                            HexCoordToCameraVector(IndexToHexCoord(i, j)),
-                            6, tileRadius, 30, BLACK);
-                        DrawRectangleV(
-                            Vector2Add((Vector2){-tileRadius, -tileRadius * 0.5},
-                                HexCoordToCameraVector(IndexToHexCoord(i, j))),
-                            (Vector2){tileRadius * 2, tileRadius * 0.5},
-                            tileColors[TILETYPE_WALL]);
-                    }
-                }
-            }
-        }
+        DrawWallSides(&view, &visible);
+        EndFrameSection(&profiler, FRAMESECTION_WALLSIDES);
         // Third pass for the top of the walls
-        for (int i = 0; i < mapRadius; i++)
-        {
-            for (int j = 0; j < mapRadius; j++)
-            {
-                hexCoord b = IndexToHexCoord(i, j);
-                if (abs(b.q) <= mapRadius / 2 && 
-                    abs(b.r) <= mapRadius / 2 && 
-                    abs(b.s) <= mapRadius / 2)
-                {
-                    if (GetTile(IndexToHexCoord(i, j)) == TILETYPE_WALL)
-                    {
-                        if (
-                            abs(player.q - b.q) < visionRadius &&
-                            abs(player.r - b.r) < visionRadius && 
-                            abs(player.s - b.s) < visionRadius)
-                        {
-                            DrawPoly(
-                                Vector2Add((Vector2){0, -tileRadius * 0.5},
-                                    HexCoordToCameraVector(IndexToHexCoord(i, j))),
-                                6, tileRadius, 30, (Color){200, 150, 0, 255});
-                            DrawPolyLines(
-                                Vector2Add((Vector2){0, -tileRadius * 0.5},
-                                    HexCoordToCameraVector(IndexToHexCoord(i, j))),
-                                6, tileRadius, 30, BLACK);
-                        }
-                    }
-                }
-            }
-        }
+        DrawWallTops(&view, &visible);
+        EndFrameSection(&profiler, FRAMESECTION_WALLTOPS);
         /* for (int i = 0; i < mapRadius; i++)
         {
             for (int j = 0; j < mapRadius; j++)
@@ -604,9 +389,65 @@ int main()
             }
         } */
 
+        int playerChunkQ, playerChunkR;
+        CoordToChunk(game.player, &playerChunkQ, &playerChunkR);
+        mapChunk *playerChunk = GetChunk(&map, playerChunkQ, playerChunkR);
+        if ((playerChunk == NULL || !playerChunk->generated) && ChunkStreamerFailed(&streamer, playerChunkQ, playerChunkR))
+        {
+            DrawText("failed to generate", GetScreenWidth() / 2 - 90, GetScreenHeight() / 2 - 60, 20, WHITE);
+        }
+        else if (playerChunk == NULL || !playerChunk->generated)
+        {
+            DrawText("generating...", GetScreenWidth() / 2 - 60, GetScreenHeight() / 2 - 60, 20, WHITE);
+        }
+        else if (timeToInteractive < 0)
+        {
+            timeToInteractive = GetTimeSeconds() - startTime;
+            printf("time to first interactive frame: %.1f ms\n", timeToInteractive * 1000);
+        }
+        if (timeToInteractive >= 0)
+        {
+            DrawText(TextFormat("interactive after %.1f ms", timeToInteractive * 1000), 10, 90, 20, WHITE);
+        }
+
         DrawFPS(10, 30);
+        DrawText(TextFormat("%.2f ms", GetFrameTime() * 1000), 10, 50, 20, WHITE);
+        DrawText(TextFormat("chunks: %d (%d KB)", MapChunkCount(&map),
+            (int)(MapChunkCount(&map) * sizeof(mapChunk) / 1024)), 10, 70, 20, WHITE);
+        DrawText(TextFormat("turn 1/%d  ants %d  rooms %d", params.turnChanceDenominator, params.antCount,
+            params.roomRadius), 10, 110, 20, WHITE);
+        if (retuneTime >= 0)
+        {
+            DrawText(TextFormat("regenerated in %.2f ms", retuneTime * 1000), 10, 130, 20, WHITE);
+        }
+        if (profiler.showOverlay)
+        {
+            DrawProfilerOverlay(&profiler, GetScreenWidth() - 330, 10);
+        }
+        EndFrameSection(&profiler, FRAMESECTION_HUD);
 
         EndDrawing();
+        EndFrameSection(&profiler, FRAMESECTION_PRESENT);
+        profiler.current.tilesConsidered = fov.lastTilesCast;
+        profiler.current.tilesDrawn = view.stats.tiles;
+        profiler.current.triangles = view.stats.triangles;
+        profiler.current.drawCalls = view.stats.drawCalls;
+        EndProfiledFrame(&profiler);
+    }
+    StopChunkStreamer(&streamer);
+    FreeVisibleTiles(&visible);
+    FreeFovCache(&fov);
+    FreeFrameProfiler(&profiler);
+    if (recorder.file != NULL && !StopRecording(&recorder, &game))
+    {
+        printf("failed to write %s\n", recordPath);
+    }
+    CloseReplay(&replay);
+    if (savePath != NULL && !SaveSnapshot(&map, savePath, params))
+    {
+        printf("failed to save %s\n", savePath);
     }
+    ClearMap(&map);
+    CloseSnapshot(&loaded);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,321 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "map.h"
+
+const hexCoord directionToCoords[6] = {
+    (hexCoord){0, -1, 1},
+    (hexCoord){1, -1, 0},
+    (hexCoord){1, 0, -1},
+    (hexCoord){0, 1, -1},
+    (hexCoord){-1, 1, 0},
+    (hexCoord){-1, 0, 1}};
+
+static uint32_t ChunkHash(int q, int r)
+{
+    uint32_t h = (uint32_t)q * 0x9E3779B1u ^ (uint32_t)r * 0x85EBCA77u;
+    h ^= h >> 15;
+    h *= 0x2C1B3C6Du;
+    h ^= h >> 12;
+    return h;
+}
+
+mapChunk *GetChunk(hexMap *map, int q, int r)
+{
+    if (map->lastChunk != NULL && map->lastChunk->q == q && map->lastChunk->r == r)
+    {
+        return map->lastChunk;
+    }
+    if (map->chunkCapacity == 0)
+    {
+        return NULL;
+    }
+
+    for (uint32_t i = ChunkHash(q, r);; i++)
+    {
+        mapChunk *chunk = map->chunks[i & (map->chunkCapacity - 1)];
+        if (chunk == NULL)
+        {
+            return NULL;
+        }
+        if (chunk->q == q && chunk->r == r)
+        {
+            map->lastChunk = chunk;
+            map->lastSlot = (int)(i & (map->chunkCapacity - 1));
+            return chunk;
+        }
+    }
+}
+
+// Returns the slot the chunk went into
+static int InsertIntoTable(mapChunk **table, int capacity, mapChunk *chunk)
+{
+    uint32_t i = ChunkHash(chunk->q, chunk->r);
+    while (table[i & (capacity - 1)] != NULL)
+    {
+        i++;
+    }
+    table[i & (capacity - 1)] = chunk;
+    return (int)(i & (capacity - 1));
+}
+
+// Records that a chunk in the map changed, the chunk was just looked up so it is the last chunk
+static void StampChunk(hexMap *map, const mapChunk *chunk)
+{
+    map->revision++;
+    if (chunk == map->lastChunk)
+    {
+        map->chunkRevisions[map->lastSlot] = map->revision;
+    }
+    else
+    {
+        // Without the slot there is no telling what depends on the chunk
+        map->staleBefore = map->revision;
+    }
+}
+
+mapChunk *CreateChunk(int q, int r)
+{
+    // calloc leaves every tile as TILETYPE_NONE
+    mapChunk *chunk = calloc(1, sizeof(mapChunk));
+    if (chunk != NULL)
+    {
+        chunk->q = q;
+        chunk->r = r;
+        chunk->owned = true;
+    }
+    return chunk;
+}
+
+bool InsertChunk(hexMap *map, mapChunk *chunk)
+{
+    map->revision++;
+    // Replace the chunk if it already exists, the table slot points to the new one
+    if (map->chunkCapacity > 0)
+    {
+        for (uint32_t i = ChunkHash(chunk->q, chunk->r);; i++)
+        {
+            int index = (int)(i & (map->chunkCapacity - 1));
+            mapChunk **slot = &map->chunks[index];
+            if (*slot == NULL)
+            {
+                break;
+            }
+            if ((*slot)->q == chunk->q && (*slot)->r == chunk->r)
+            {
+                if (*slot != chunk)
+                {
+                    FreeChunk(*slot);
+                }
+                *slot = chunk;
+                map->chunkRevisions[index] = map->revision;
+                map->lastChunk = chunk;
+                map->lastSlot = index;
+                return true;
+            }
+        }
+    }
+
+    // Keep the table at most half full so probing stays short
+    if ((map->chunkCount + 1) * 2 > map->chunkCapacity)
+    {
+        int capacity = map->chunkCapacity == 0 ? 16 : map->chunkCapacity * 2;
+        mapChunk **table = calloc(capacity, sizeof(mapChunk *));
+        uint32_t *revisions = calloc(capacity, sizeof(uint32_t));
+        if (table == NULL || revisions == NULL)
+        {
+            free(table);
+            free(revisions);
+            return false;
+        }
+        for (int i = 0; i < map->chunkCapacity; i++)
+        {
+            if (map->chunks[i] != NULL)
+            {
+                revisions[InsertIntoTable(table, capacity, map->chunks[i])] = map->chunkRevisions[i];
+            }
+        }
+        free(map->chunks);
+        free(map->chunkRevisions);
+        map->chunks = table;
+        map->chunkRevisions = revisions;
+        map->chunkCapacity = capacity;
+    }
+
+    int index = InsertIntoTable(map->chunks, map->chunkCapacity, chunk);
+    map->chunkRevisions[index] = map->revision;
+    map->chunkCount++;
+    map->lastChunk = chunk;
+    map->lastSlot = index;
+    return true;
+}
+
+void FreeChunk(mapChunk *chunk)
+{
+    if (chunk != NULL && chunk->owned)
+    {
+        free(chunk->trails);
+        free(chunk);
+    }
+}
+
+mapChunk *GetOrCreateChunk(hexMap *map, int q, int r)
+{
+    mapChunk *chunk = GetChunk(map, q, r);
+    if (chunk != NULL)
+    {
+        return chunk;
+    }
+
+    chunk = CreateChunk(q, r);
+    if (chunk != NULL && !InsertChunk(map, chunk))
+    {
+        FreeChunk(chunk);
+        return NULL;
+    }
+    return chunk;
+}
+
+void CoordToChunk(hexCoord coord, int *q, int *r)
+{
+    // CHUNK_SIZE is a power of 2 so an arithmetic shift rounds towards negative infinity without a branch
+    *q = (coord.q + CHUNK_SIZE / 2) >> CHUNK_SHIFT;
+    *r = (coord.r + CHUNK_SIZE / 2) >> CHUNK_SHIFT;
+}
+
+hexCoord ChunkCentre(int q, int r)
+{
+    return (hexCoord){q * CHUNK_SIZE, r * CHUNK_SIZE, -(q + r) * CHUNK_SIZE};
+}
+
+int MapChunkCount(const hexMap *map)
+{
+    return map->chunkCount;
+}
+
+void CollectChunks(const hexMap *map, mapChunk **out)
+{
+    for (int i = 0; i < map->chunkCapacity; i++)
+    {
+        if (map->chunks[i] != NULL)
+        {
+            *out++ = map->chunks[i];
+        }
+    }
+}
+
+void ClearMap(hexMap *map)
+{
+    for (int i = 0; i < map->chunkCapacity; i++)
+    {
+        FreeChunk(map->chunks[i]);
+    }
+    free(map->chunks);
+    free(map->chunkRevisions);
+    // The revision keeps counting so sets computed before the map was cleared stay stale
+    *map = (hexMap){.revision = map->revision + 1, .staleBefore = map->revision + 1};
+}
+
+uint32_t MapRevision(const hexMap *map)
+{
+    return map->revision;
+}
+
+void MarkMapChanged(hexMap *map)
+{
+    map->revision++;
+    map->staleBefore = map->revision;
+}
+
+bool MapChangedAround(hexMap *map, hexCoord centre, int radius, uint32_t revision)
+{
+    if (map->staleBefore > revision)
+    {
+        return true;
+    }
+    // The chunks that overlap the square around the tile, a chunk that wasn't there before has a newer revision
+    int firstQ, firstR, lastQ, lastR;
+    CoordToChunk((hexCoord){centre.q - radius, centre.r - radius, 0}, &firstQ, &firstR);
+    CoordToChunk((hexCoord){centre.q + radius, centre.r + radius, 0}, &lastQ, &lastR);
+    for (int q = firstQ; q <= lastQ; q++)
+    {
+        for (int r = firstR; r <= lastR; r++)
+        {
+            if (GetChunk(map, q, r) != NULL && map->chunkRevisions[map->lastSlot] > revision)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// The low bits of the shifted coordinates are the position in the chunk
+int ChunkTileIndex(hexCoord coord)
+{
+    return ((coord.q + CHUNK_SIZE / 2) & (CHUNK_SIZE - 1)) * CHUNK_SIZE + ((coord.r + CHUNK_SIZE / 2) & (CHUNK_SIZE - 1));
+}
+
+TILETYPE GetTile(hexMap *map, hexCoord coord)
+{
+    int q, r;
+    CoordToChunk(coord, &q, &r);
+    mapChunk *chunk = GetChunk(map, q, r);
+    if (chunk == NULL)
+    {
+        return TILETYPE_NONE;
+    }
+    return (TILETYPE)chunk->tiles[ChunkTileIndex(coord)];
+}
+
+void SetChunkTile(mapChunk *chunk, hexCoord coord, TILETYPE tile)
+{
+    chunk->tiles[ChunkTileIndex(coord)] = (uint8_t)tile;
+}
+
+void SetTile(hexMap *map, hexCoord coord, TILETYPE tile)
+{
+    int q, r;
+    CoordToChunk(coord, &q, &r);
+    mapChunk *chunk = GetOrCreateChunk(map, q, r);
+    if (chunk != NULL)
+    {
+        chunk->tiles[ChunkTileIndex(coord)] = (uint8_t)tile;
+        StampChunk(map, chunk);
+    }
+}
+
+void SetTileRow(hexMap *map, hexCoord start, const uint8_t *tiles, int count)
+{
+    while (count > 0)
+    {
+        int q, r;
+        CoordToChunk(start, &q, &r);
+        mapChunk *chunk = GetOrCreateChunk(map, q, r);
+        int index = ChunkTileIndex(start);
+        // The rest of the row in this chunk
+        int run = CHUNK_SIZE - (index & (CHUNK_SIZE - 1));
+        run = run < count ? run : count;
+        if (chunk != NULL)
+        {
+            memcpy(&chunk->tiles[index], tiles, run);
+            StampChunk(map, chunk);
+        }
+        start.r += run;
+        start.s -= run;
+        tiles += run;
+        count -= run;
+    }
+}
+
+hexCoord IndexToHexCoord(int q, int r)
+{
+    q = (q % 2 == 0 ? -q : q + 1) / 2;
+    r = (r % 2 == 0 ? -r : r + 1) / 2;
+    return (hexCoord){q, r, -q - r};
+}
+
+hexCoord HexCoordAdd(hexCoord a, hexCoord b)
+{
+    return (hexCoord){a.q + b.q, a.r + b.r, a.s + b.s};
+}
@@ -0,0 +1,107 @@
+#ifndef MAP_H
+#define MAP_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum TILETYPE
+{
+    TILETYPE_NONE,
+    TILETYPE_FLOOR,
+    TILETYPE_WALL,
+    TILETYPE_HOLE
+} TILETYPE;
+
+typedef struct hexCoord
+{
+    int q;
+    int r;
+    int s;
+} hexCoord;
+
+// The map is stored in chunks of CHUNK_SIZE * CHUNK_SIZE tiles that are created when a tile in them is first set,
+// so memory grows with the area that has been generated instead of a fixed square
+#define CHUNK_SIZE 64
+#define CHUNK_SHIFT 6
+
+struct chunkTrails;
+
+typedef struct mapChunk
+{
+    // Chunk coordinates, chunk (0, 0) is centred on the tile (0, 0, 0)
+    int32_t q;
+    int32_t r;
+    // What the generator kept to carve the rooms again, NULL unless asked for. Only owned chunks have trails,
+    // snapshots are written with NULL here
+    struct chunkTrails *trails;
+    // Set once the terrain generator has filled the chunk
+    uint8_t generated;
+    // Chunks loaded from a snapshot live in the mapped file and aren't freed with the map
+    uint8_t owned;
+    // The layout is fixed so chunks can be written to and mapped from snapshot files as they are
+    uint8_t padding[6];
+    // A TILETYPE per tile, one byte each since there are only 4 tile types
+    uint8_t tiles[CHUNK_SIZE * CHUNK_SIZE];
+} mapChunk;
+
+// A map of chunks, every map is separate so several can be generated at once on different threads.
+// A map set to {0} is empty
+typedef struct hexMap
+{
+    // Open addressing hash map from chunk coordinates to chunks, the capacity is always a power of 2
+    mapChunk **chunks;
+    int chunkCapacity;
+    int chunkCount;
+    // The revision every chunk last changed at, by table slot
+    uint32_t *chunkRevisions;
+    // Most accesses are close to the previous one so the last chunk is checked before the hash map
+    mapChunk *lastChunk;
+    int lastSlot;
+    uint32_t revision;
+    // Anything computed before this revision is stale no matter which chunks it looked at
+    uint32_t staleBefore;
+} hexMap;
+
+extern const hexCoord directionToCoords[6];
+
+// Tiles in chunks that don't exist are TILETYPE_NONE
+TILETYPE GetTile(hexMap *map, hexCoord coord);
+void SetTile(hexMap *map, hexCoord coord, TILETYPE tile);
+
+// Sets count tiles going in the +r direction from start, a chunk at a time
+void SetTileRow(hexMap *map, hexCoord start, const uint8_t *tiles, int count);
+
+// Sets a tile in a chunk that doesn't have to be in the map, the coordinate must be inside the chunk
+void SetChunkTile(mapChunk *chunk, hexCoord coord, TILETYPE tile);
+// Index of the tile in the tiles of the chunk the coordinate is in
+int ChunkTileIndex(hexCoord coord);
+
+mapChunk *GetChunk(hexMap *map, int q, int r);
+// Allocates a chunk without adding it to the map, so it can be filled on another thread
+mapChunk *CreateChunk(int q, int r);
+// Adds a chunk to the map, an existing chunk with the same coordinates is freed, the map owns the chunk afterwards
+bool InsertChunk(hexMap *map, mapChunk *chunk);
+// Frees a chunk that isn't in the map along with its trails
+void FreeChunk(mapChunk *chunk);
+// Creates the chunk with all tiles set to TILETYPE_NONE if it doesn't exist, returns NULL if out of memory
+mapChunk *GetOrCreateChunk(hexMap *map, int q, int r);
+void CoordToChunk(hexCoord coord, int *q, int *r);
+hexCoord ChunkCentre(int q, int r);
+int MapChunkCount(const hexMap *map);
+// Writes a pointer to every chunk in the map to chunks, which needs room for MapChunkCount() pointers
+void CollectChunks(const hexMap *map, mapChunk **chunks);
+// Frees all chunks, chunks that aren't owned by the map are only forgotten
+void ClearMap(hexMap *map);
+// Changes every time a tile or chunk in the map changes, so anything computed from the map can tell it is stale.
+// SetChunkTile doesn't count since it is used on chunks that aren't in the map, MarkMapChanged is for those changes
+// and makes everything computed before it stale
+uint32_t MapRevision(const hexMap *map);
+void MarkMapChanged(hexMap *map);
+// True if a tile within radius of centre may have changed since the revision. Chunks further away don't count, so
+// what is computed from the tiles around a tile stays valid while chunks are added elsewhere
+bool MapChangedAround(hexMap *map, hexCoord centre, int radius, uint32_t revision);
+
+hexCoord IndexToHexCoord(int q, int r);
+hexCoord HexCoordAdd(hexCoord a, hexCoord b);
+
+#endif
@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "raylib.h"
+
+#include "profiler.h"
+#include "generator.h"
+
+const char *frameSectionNames[FRAMESECTION_COUNT] = {
+    "input",
+    "stream",
+    "camera",
+    "fov",
+    "floor",
+    "wallSides",
+    "wallTops",
+    "hud",
+    "present"};
+
+bool InitFrameProfiler(frameProfiler *profiler, int capacity)
+{
+    memset(profiler, 0, sizeof(frameProfiler));
+    profiler->frames = malloc(sizeof(frameSample) * capacity);
+    profiler->sortedTimes = malloc(sizeof(double) * capacity);
+    if (profiler->frames == NULL || profiler->sortedTimes == NULL)
+    {
+        FreeFrameProfiler(profiler);
+        return false;
+    }
+    profiler->capacity = capacity;
+    return true;
+}
+
+void FreeFrameProfiler(frameProfiler *profiler)
+{
+    free(profiler->frames);
+    free(profiler->sortedTimes);
+    profiler->frames = NULL;
+    profiler->sortedTimes = NULL;
+    profiler->capacity = 0;
+    profiler->count = 0;
+}
+
+void BeginProfiledFrame(frameProfiler *profiler)
+{
+    memset(&profiler->current, 0, sizeof(frameSample));
+    profiler->frameStart = GetTimeSeconds();
+    profiler->sectionStart = profiler->frameStart;
+}
+
+void EndFrameSection(frameProfiler *profiler, FRAMESECTION section)
+{
+    double now = GetTimeSeconds();
+    profiler->current.sectionTime[section] += now - profiler->sectionStart;
+    profiler->sectionStart = now;
+}
+
+void EndProfiledFrame(frameProfiler *profiler)
+{
+    profiler->current.frameTime = GetTimeSeconds() - profiler->frameStart;
+    profiler->frames[profiler->next] = profiler->current;
+    profiler->next = (profiler->next + 1) % profiler->capacity;
+    if (profiler->count < profiler->capacity)
+    {
+        profiler->count++;
+    }
+}
+
+static int CompareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+frameSummary SummarizeFrames(frameProfiler *profiler)
+{
+    frameSummary summary = {0};
+    summary.frames = profiler->count;
+    if (profiler->count == 0)
+    {
+        return summary;
+    }
+
+    // The percentile needs the times sorted, a few hundred doubles are cheap to sort once per frame
+    double *times = profiler->sortedTimes;
+    summary.minTime = profiler->frames[0].frameTime;
+    for (int i = 0; i < profiler->count; i++)
+    {
+        const frameSample *frame = &profiler->frames[i];
+        times[i] = frame->frameTime;
+        summary.minTime = frame->frameTime < summary.minTime ? frame->frameTime : summary.minTime;
+        summary.averageTime += frame->frameTime;
+        for (int s = 0; s < FRAMESECTION_COUNT; s++)
+        {
+            summary.sectionAverage[s] += frame->sectionTime[s];
+        }
+        summary.tilesConsidered += frame->tilesConsidered;
+        summary.tilesDrawn += frame->tilesDrawn;
+        summary.triangles += frame->triangles;
+        summary.drawCalls += frame->drawCalls;
+    }
+    qsort(times, profiler->count, sizeof(double), CompareDoubles);
+    summary.p99Time = times[(profiler->count * 99 + 99) / 100 - 1];
+
+    summary.averageTime /= profiler->count;
+    for (int s = 0; s < FRAMESECTION_COUNT; s++)
+    {
+        summary.sectionAverage[s] /= profiler->count;
+    }
+    summary.tilesConsidered /= profiler->count;
+    summary.tilesDrawn /= profiler->count;
+    summary.triangles /= profiler->count;
+    summary.drawCalls /= profiler->count;
+    return summary;
+}
+
+void DrawProfilerOverlay(frameProfiler *profiler, int x, int y)
+{
+    frameSummary summary = SummarizeFrames(profiler);
+    int lineHeight = 20;
+    DrawRectangle(x, y, 320, lineHeight * (FRAMESECTION_COUNT + 5) + 10, (Color){0, 0, 0, 180});
+    x += 10;
+    y += 5;
+    DrawText(TextFormat("frame min %.2f avg %.2f p99 %.2f ms", summary.minTime * 1000, summary.averageTime * 1000,
+        summary.p99Time * 1000), x, y, 18, WHITE);
+    y += lineHeight;
+    DrawText(TextFormat("over the last %d frames", summary.frames), x, y, 18, GRAY);
+    y += lineHeight;
+    for (int s = 0; s < FRAMESECTION_COUNT; s++)
+    {
+        DrawText(TextFormat("%-10s %.3f ms", frameSectionNames[s], summary.sectionAverage[s] * 1000), x, y, 18, WHITE);
+        y += lineHeight;
+    }
+    DrawText(TextFormat("tiles considered %.0f drawn %.0f", summary.tilesConsidered, summary.tilesDrawn), x, y, 18, WHITE);
+    y += lineHeight;
+    DrawText(TextFormat("triangles %.0f draw calls %.1f", summary.triangles, summary.drawCalls), x, y, 18, WHITE);
+    y += lineHeight;
+    DrawText("F3 hide, F4 write capture", x, y, 18, GRAY);
+}
+
+bool WriteFrameCapture(const frameProfiler *profiler, const char *path)
+{
+    FILE *file = fopen(path, "w");
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    fprintf(file, "frame,frameMs");
+    for (int s = 0; s < FRAMESECTION_COUNT; s++)
+    {
+        fprintf(file, ",%sMs", frameSectionNames[s]);
+    }
+    fprintf(file, ",tilesConsidered,tilesDrawn,triangles,drawCalls\n");
+
+    // Oldest frame first
+    int first = profiler->count < profiler->capacity ? 0 : profiler->next;
+    for (int i = 0; i < profiler->count; i++)
+    {
+        const frameSample *frame = &profiler->frames[(first + i) % profiler->capacity];
+        fprintf(file, "%d,%.4f", i, frame->frameTime * 1000);
+        for (int s = 0; s < FRAMESECTION_COUNT; s++)
+        {
+            fprintf(file, ",%.4f", frame->sectionTime[s] * 1000);
+        }
+        fprintf(file, ",%d,%d,%d,%d\n", frame->tilesConsidered, frame->tilesDrawn, frame->triangles, frame->drawCalls);
+    }
+    return fclose(file) == 0;
+}
@@ -0,0 +1,83 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdbool.h>
+
+// The parts of a frame in the order the game loop runs them
+typedef enum FRAMESECTION
+{
+    FRAMESECTION_INPUT,
+    FRAMESECTION_STREAM,
+    FRAMESECTION_CAMERA,
+    FRAMESECTION_FOV,
+    FRAMESECTION_FLOOR,
+    FRAMESECTION_WALLSIDES,
+    FRAMESECTION_WALLTOPS,
+    FRAMESECTION_HUD,
+    // EndDrawing, where the batches are actually sent to the GPU and the frame waits for vsync
+    FRAMESECTION_PRESENT,
+    FRAMESECTION_COUNT
+} FRAMESECTION;
+
+extern const char *frameSectionNames[FRAMESECTION_COUNT];
+
+typedef struct frameSample
+{
+    // Seconds spent in each section
+    double sectionTime[FRAMESECTION_COUNT];
+    double frameTime;
+    // Tiles the field of view cast over, 0 when it was cached, and tiles the layers drew
+    int tilesConsidered;
+    int tilesDrawn;
+    int triangles;
+    int drawCalls;
+} frameSample;
+
+// Frames the game keeps for the rolling numbers and the capture, about five seconds at 60 fps
+#define PROFILER_FRAMES 300
+
+typedef struct frameProfiler
+{
+    // A ring of the last capacity frames, next is where the next frame goes
+    frameSample *frames;
+    int capacity;
+    int next;
+    int count;
+    // The frame being measured, the counts are filled in by the game loop
+    frameSample current;
+    double frameStart;
+    double sectionStart;
+    bool showOverlay;
+    // Scratch space for sorting the frame times
+    double *sortedTimes;
+} frameProfiler;
+
+typedef struct frameSummary
+{
+    double minTime;
+    double averageTime;
+    double p99Time;
+    double sectionAverage[FRAMESECTION_COUNT];
+    double tilesConsidered;
+    double tilesDrawn;
+    double triangles;
+    double drawCalls;
+    int frames;
+} frameSummary;
+
+// Keeps the last capacity frames, returns false if out of memory
+bool InitFrameProfiler(frameProfiler *profiler, int capacity);
+void FreeFrameProfiler(frameProfiler *profiler);
+void BeginProfiledFrame(frameProfiler *profiler);
+// Adds the time since the last section ended to this section
+void EndFrameSection(frameProfiler *profiler, FRAMESECTION section);
+// Stores the frame in the ring, the counts in profiler->current have to be filled in before
+void EndProfiledFrame(frameProfiler *profiler);
+// Min, average and 99th percentile frame time and the average of everything else over the kept frames
+frameSummary SummarizeFrames(frameProfiler *profiler);
+// Draws the summary in a box with its top left corner at x, y
+void DrawProfilerOverlay(frameProfiler *profiler, int x, int y);
+// Writes the kept frames as CSV, one row per frame with the times in milliseconds, returns false if it can't be written
+bool WriteFrameCapture(const frameProfiler *profiler, const char *path);
+
+#endif
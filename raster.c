@@ -0,0 +1,184 @@
+#include <stdlib.h>
+#include <math.h>
+
+#include "raster.h"
+
+// Vertices are snapped to 1/16 of a pixel so the edges are tested with integers, the same frame is then drawn the
+// same on every machine and the checksums can be compared between them
+#define SUBPIXEL_BITS 4
+#define SUBPIXEL (1 << SUBPIXEL_BITS)
+// Far enough outside any frame that clamping doesn't move an edge that crosses it, small enough for the products
+#define FIXED_LIMIT (1 << 24)
+
+bool CreateFramebuffer(framebuffer *target, int width, int height)
+{
+    target->pixels = malloc(sizeof(Color) * width * height);
+    if (target->pixels == NULL)
+    {
+        return false;
+    }
+    target->width = width;
+    target->height = height;
+    return true;
+}
+
+void FreeFramebuffer(framebuffer *target)
+{
+    free(target->pixels);
+    target->pixels = NULL;
+}
+
+void ClearFramebuffer(framebuffer *target, Color color)
+{
+    int count = target->width * target->height;
+    for (int i = 0; i < count; i++)
+    {
+        target->pixels[i] = color;
+    }
+}
+
+static inline void BlendPixel(Color *pixel, Color color)
+{
+    if (color.a == 255)
+    {
+        *pixel = color;
+        return;
+    }
+    int a = color.a;
+    pixel->r = (unsigned char)((color.r * a + pixel->r * (255 - a)) / 255);
+    pixel->g = (unsigned char)((color.g * a + pixel->g * (255 - a)) / 255);
+    pixel->b = (unsigned char)((color.b * a + pixel->b * (255 - a)) / 255);
+    pixel->a = (unsigned char)(a + pixel->a * (255 - a) / 255);
+}
+
+typedef struct fixedPoint
+{
+    int64_t x;
+    int64_t y;
+} fixedPoint;
+
+static fixedPoint ToFixed(Vector2 v)
+{
+    float limit = FIXED_LIMIT / SUBPIXEL;
+    float x = v.x < -limit ? -limit : v.x > limit ? limit : v.x;
+    float y = v.y < -limit ? -limit : v.y > limit ? limit : v.y;
+    return (fixedPoint){lrintf(x * SUBPIXEL), lrintf(y * SUBPIXEL)};
+}
+
+// Twice the signed area of a, b, p, positive when p is on the inside of the edge a to b
+static inline int64_t EdgeFunction(fixedPoint a, fixedPoint b, fixedPoint p)
+{
+    return (b.x - a.x) * (p.y - a.y) - (b.y - a.y) * (p.x - a.x);
+}
+
+// A pixel centre exactly on an edge belongs to the triangle if the edge runs up, or right when it is flat. The
+// triangle on the other side of the edge runs it the other way, so the pixel is filled exactly once
+static inline int64_t EdgeBias(fixedPoint a, fixedPoint b)
+{
+    return (b.y < a.y || (b.y == a.y && b.x > a.x)) ? 0 : -1;
+}
+
+void RasterTriangle(framebuffer *target, Vector2 a, Vector2 b, Vector2 c, Color color)
+{
+    if (color.a == 0)
+    {
+        return;
+    }
+    fixedPoint p0 = ToFixed(a);
+    fixedPoint p1 = ToFixed(b);
+    fixedPoint p2 = ToFixed(c);
+    int64_t area = EdgeFunction(p0, p1, p2);
+    if (area == 0)
+    {
+        return;
+    }
+    if (area < 0)
+    {
+        fixedPoint swap = p1;
+        p1 = p2;
+        p2 = swap;
+    }
+
+    // Only the pixels whose centres can be inside, clipped to the frame
+    int64_t minX = p0.x < p1.x ? (p0.x < p2.x ? p0.x : p2.x) : (p1.x < p2.x ? p1.x : p2.x);
+    int64_t maxX = p0.x > p1.x ? (p0.x > p2.x ? p0.x : p2.x) : (p1.x > p2.x ? p1.x : p2.x);
+    int64_t minY = p0.y < p1.y ? (p0.y < p2.y ? p0.y : p2.y) : (p1.y < p2.y ? p1.y : p2.y);
+    int64_t maxY = p0.y > p1.y ? (p0.y > p2.y ? p0.y : p2.y) : (p1.y > p2.y ? p1.y : p2.y);
+    int left = minX < 0 ? 0 : (int)(minX >> SUBPIXEL_BITS);
+    int right = maxX >> SUBPIXEL_BITS >= target->width ? target->width - 1 : (int)(maxX >> SUBPIXEL_BITS);
+    int top = minY < 0 ? 0 : (int)(minY >> SUBPIXEL_BITS);
+    int bottom = maxY >> SUBPIXEL_BITS >= target->height ? target->height - 1 : (int)(maxY >> SUBPIXEL_BITS);
+    if (left > right || top > bottom)
+    {
+        return;
+    }
+
+    // The edge functions at the first pixel centre, moving a pixel right or down changes them by a constant
+    fixedPoint start = {(int64_t)left * SUBPIXEL + SUBPIXEL / 2, (int64_t)top * SUBPIXEL + SUBPIXEL / 2};
+    int64_t row0 = EdgeFunction(p1, p2, start) + EdgeBias(p1, p2);
+    int64_t row1 = EdgeFunction(p2, p0, start) + EdgeBias(p2, p0);
+    int64_t row2 = EdgeFunction(p0, p1, start) + EdgeBias(p0, p1);
+    int64_t stepX0 = -(p2.y - p1.y) * SUBPIXEL;
+    int64_t stepX1 = -(p0.y - p2.y) * SUBPIXEL;
+    int64_t stepX2 = -(p1.y - p0.y) * SUBPIXEL;
+    int64_t stepY0 = (p2.x - p1.x) * SUBPIXEL;
+    int64_t stepY1 = (p0.x - p2.x) * SUBPIXEL;
+    int64_t stepY2 = (p1.x - p0.x) * SUBPIXEL;
+
+    for (int y = top; y <= bottom; y++)
+    {
+        int64_t w0 = row0;
+        int64_t w1 = row1;
+        int64_t w2 = row2;
+        Color *pixel = &target->pixels[y * target->width + left];
+        for (int x = left; x <= right; x++, pixel++)
+        {
+            if ((w0 | w1 | w2) >= 0)
+            {
+                BlendPixel(pixel, color);
+            }
+            w0 += stepX0;
+            w1 += stepX1;
+            w2 += stepX2;
+        }
+        row0 += stepY0;
+        row1 += stepY1;
+        row2 += stepY2;
+    }
+}
+
+void RasterCircle(framebuffer *target, Vector2 centre, float radius, Color color)
+{
+    int left = (int)floorf(centre.x - radius);
+    int right = (int)ceilf(centre.x + radius);
+    int top = (int)floorf(centre.y - radius);
+    int bottom = (int)ceilf(centre.y + radius);
+    left = left < 0 ? 0 : left;
+    top = top < 0 ? 0 : top;
+    right = right >= target->width ? target->width - 1 : right;
+    bottom = bottom >= target->height ? target->height - 1 : bottom;
+    for (int y = top; y <= bottom; y++)
+    {
+        float dy = y + 0.5f - centre.y;
+        for (int x = left; x <= right; x++)
+        {
+            float dx = x + 0.5f - centre.x;
+            if (dx * dx + dy * dy <= radius * radius)
+            {
+                BlendPixel(&target->pixels[y * target->width + x], color);
+            }
+        }
+    }
+}
+
+uint32_t FramebufferChecksum(const framebuffer *target)
+{
+    uint32_t hash = 2166136261u;
+    int count = target->width * target->height;
+    for (int i = 0; i < count; i++)
+    {
+        Color pixel = target->pixels[i];
+        hash = (hash ^ (uint32_t)(pixel.r | pixel.g << 8 | pixel.b << 16 | (uint32_t)pixel.a << 24)) * 16777619u;
+    }
+    return hash;
+}
@@ -0,0 +1,29 @@
+#ifndef RASTER_H
+#define RASTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "raylib.h"
+
+// A frame in memory that the tile passes can draw into instead of the window, so rendering can be timed and
+// checked without a display or a GPU
+typedef struct framebuffer
+{
+    int width;
+    int height;
+    // Row by row from the top left, the same layout as an uncompressed raylib Image
+    Color *pixels;
+} framebuffer;
+
+bool CreateFramebuffer(framebuffer *target, int width, int height);
+void FreeFramebuffer(framebuffer *target);
+void ClearFramebuffer(framebuffer *target, Color color);
+// Fills the pixels whose centres are inside the triangle, pixels on an edge shared by two triangles are only filled
+// by one of them. Either winding works, colors with an alpha below 255 are blended over the frame
+void RasterTriangle(framebuffer *target, Vector2 a, Vector2 b, Vector2 c, Color color);
+void RasterCircle(framebuffer *target, Vector2 centre, float radius, Color color);
+// FNV-1a over the pixels, the same frame always gives the same checksum
+uint32_t FramebufferChecksum(const framebuffer *target);
+
+#endif
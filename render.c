@@ -0,0 +1,226 @@
+#include <stdlib.h>
+#include <math.h>
+
+#include "raylib.h"
+#include "raymath.h"
+#include "rlgl.h"
+
+#include "render.h"
+
+const Color tileColors[4] = {
+    (Color){0, 0, 0, 0},
+    (Color){220, 200, 50, 255},
+    (Color){100, 80, 0, 255},
+    (Color){100, 100, 255, 255}};
+
+void InitRenderView(renderView *view)
+{
+    *view = (renderView){0};
+    view->tileRadius = 80;
+}
+
+Vector2 HexCoordToVector(const renderView *view, hexCoord coord)
+{
+    float x = view->tileRadius * 1.5 * coord.q;
+    float y = (coord.s - coord.r) * sqrt(3) * view->tileRadius * 0.5;
+    return (Vector2){x, y};
+}
+
+Vector2 HexCoordToCameraVector(const renderView *view, hexCoord coord)
+{
+    float x = view->tileRadius * 1.5 * coord.q + view->cameraPos.x;
+    float y = (coord.s - coord.r) * sqrt(3) * view->tileRadius * 0.5 + view->cameraPos.y;
+    return (Vector2){x, y};
+}
+
+bool BuildVisibleTiles(const renderView *view, visibleTiles *list, const visibleSet *set)
+{
+    list->count = 0;
+    list->wallCount = 0;
+    if (list->capacity < set->count)
+    {
+        // The old blocks stay in the list if either fails, a block that did grow is kept
+        visibleTile *tiles = realloc(list->tiles, sizeof(visibleTile) * set->count);
+        if (tiles == NULL)
+        {
+            return false;
+        }
+        list->tiles = tiles;
+        int *walls = realloc(list->walls, sizeof(int) * set->count);
+        if (walls == NULL)
+        {
+            return false;
+        }
+        list->walls = walls;
+        list->capacity = set->count;
+    }
+
+    for (int i = 0; i < set->count; i++)
+    {
+        seenTile seen = set->tiles[i];
+        if (seen.tile == TILETYPE_WALL)
+        {
+            list->walls[list->wallCount++] = list->count;
+        }
+        list->tiles[list->count++] = (visibleTile){seen.coord, HexCoordToCameraVector(view, seen.coord), seen.tile};
+    }
+    return true;
+}
+
+void FreeVisibleTiles(visibleTiles *list)
+{
+    free(list->tiles);
+    free(list->walls);
+    *list = (visibleTiles){0};
+}
+
+// Corners of a hexagon with radius 1 rotated by 30 degrees, the same corners DrawPoly(..., 6, r, 30, ...) uses
+static const Vector2 hexCorners[6] = {
+    {0.8660254f, 0.5f},
+    {0, 1},
+    {-0.8660254f, 0.5f},
+    {-0.8660254f, -0.5f},
+    {0, -1},
+    {0.8660254f, -0.5f}};
+
+// Width of the black outline in pixels
+#define OUTLINE_WIDTH 1.0f
+#define HEX_VERTICES 12
+#define OUTLINED_HEX_VERTICES (HEX_VERTICES * 2)
+
+// The template scaled to the tile size for one layer, the corners are only multiplied once per frame
+typedef struct hexTemplate
+{
+    Vector2 outer[6];
+    Vector2 inner[6];
+} hexTemplate;
+
+static hexTemplate ScaleHexTemplate(float radius)
+{
+    hexTemplate scaled;
+    float inner = radius - OUTLINE_WIDTH > 0 ? radius - OUTLINE_WIDTH : 0;
+    for (int i = 0; i < 6; i++)
+    {
+        scaled.outer[i] = Vector2Scale(hexCorners[i], radius);
+        scaled.inner[i] = Vector2Scale(hexCorners[i], inner);
+    }
+    return scaled;
+}
+
+// Every layer is one batch of triangles in raylib, the framebuffer is drawn into right away
+static void BeginLayer(renderView *view)
+{
+    if (view->target == NULL)
+    {
+        rlBegin(RL_TRIANGLES);
+    }
+    view->stats.drawCalls++;
+}
+
+static void EndLayer(renderView *view)
+{
+    if (view->target == NULL)
+    {
+        rlEnd();
+    }
+}
+
+// Makes room for the vertices in raylib's batch, the limit check draws the batch when it is full
+static void ReserveVertices(renderView *view, int count)
+{
+    if (view->target == NULL)
+    {
+        view->stats.drawCalls += rlCheckRenderBatchLimit(count);
+    }
+}
+
+static void EmitTriangle(renderView *view, Vector2 a, Vector2 b, Vector2 c, Color color)
+{
+    view->stats.triangles++;
+    if (view->target != NULL)
+    {
+        RasterTriangle(view->target, a, b, c, color);
+        return;
+    }
+    rlColor4ub(color.r, color.g, color.b, color.a);
+    rlVertex2f(a.x, a.y);
+    rlVertex2f(b.x, b.y);
+    rlVertex2f(c.x, c.y);
+}
+
+// Emits a hexagon as four triangles fanned out from the first corner, wound the same way as DrawPoly
+static void EmitHex(renderView *view, Vector2 centre, const Vector2 corners[6], Color color)
+{
+    Vector2 first = Vector2Add(centre, corners[0]);
+    for (int i = 1; i < 5; i++)
+    {
+        EmitTriangle(view, first, Vector2Add(centre, corners[i + 1]), Vector2Add(centre, corners[i]), color);
+    }
+}
+
+// The outline is a black hexagon under a slightly smaller filled one. Keeping it in triangles instead of lines
+// means the whole layer stays in one draw call and a tile still covers the outlines of the tiles drawn before it
+static void EmitOutlinedHex(renderView *view, Vector2 centre, const hexTemplate *scaled, Color color)
+{
+    ReserveVertices(view, OUTLINED_HEX_VERTICES);
+    view->stats.tiles++;
+    EmitHex(view, centre, scaled->outer, BLACK);
+    EmitHex(view, centre, scaled->inner, color);
+}
+
+void DrawFloorTiles(renderView *view, const visibleTiles *list)
+{
+    hexTemplate scaled = ScaleHexTemplate(view->tileRadius);
+    BeginLayer(view);
+    for (int i = 0; i < list->count; i++)
+    {
+        EmitOutlinedHex(view, list->tiles[i].position, &scaled, tileColors[list->tiles[i].tile]);
+    }
+    EndLayer(view);
+}
+
+void DrawWallSides(renderView *view, const visibleTiles *list)
+{
+    hexTemplate scaled = ScaleHexTemplate(view->tileRadius);
+    Color color = tileColors[TILETYPE_WALL];
+    BeginLayer(view);
+    for (int i = 0; i < list->wallCount; i++)
+    {
+        Vector2 position = list->tiles[list->walls[i]].position;
+        EmitOutlinedHex(view, position, &scaled, color);
+
+        // The side of the wall between the hexagon and the top that gets drawn half a tile higher
+        ReserveVertices(view, 6);
+        float radius = view->tileRadius;
+        Vector2 topLeft = {position.x - radius, position.y - radius * 0.5f};
+        Vector2 topRight = {position.x + radius, position.y - radius * 0.5f};
+        Vector2 bottomLeft = {position.x - radius, position.y};
+        Vector2 bottomRight = {position.x + radius, position.y};
+        EmitTriangle(view, topLeft, bottomLeft, topRight, color);
+        EmitTriangle(view, topRight, bottomLeft, bottomRight, color);
+    }
+    EndLayer(view);
+}
+
+void DrawWallTops(renderView *view, const visibleTiles *list)
+{
+    hexTemplate scaled = ScaleHexTemplate(view->tileRadius);
+    BeginLayer(view);
+    for (int i = 0; i < list->wallCount; i++)
+    {
+        Vector2 position = Vector2Add((Vector2){0, -view->tileRadius * 0.5}, list->tiles[list->walls[i]].position);
+        EmitOutlinedHex(view, position, &scaled, (Color){200, 150, 0, 255});
+    }
+    EndLayer(view);
+}
+
+void DrawPlayer(const renderView *view, Vector2 position)
+{
+    Color color = (Color){255, 0, 0, 255};
+    if (view->target != NULL)
+    {
+        RasterCircle(view->target, position, view->tileRadius * 0.8f, color);
+        return;
+    }
+    DrawCircleV(position, view->tileRadius * 0.8f, color);
+}
@@ -0,0 +1,71 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "raylib.h"
+
+#include "map.h"
+#include "fov.h"
+#include "raster.h"
+
+extern const Color tileColors[4];
+
+typedef struct visibleTile
+{
+    hexCoord coord;
+    // Screen position of the tile's centre
+    Vector2 position;
+    TILETYPE tile;
+} visibleTile;
+
+// The tiles around the player that get drawn this frame
+typedef struct visibleTiles
+{
+    visibleTile *tiles;
+    int count;
+    int capacity;
+    // Walls are kept in their own list so the wall passes don't have to skip the floors
+    int *walls;
+    int wallCount;
+} visibleTiles;
+
+// What the tile layers sent to raylib since the counters were last cleared
+typedef struct renderCounters
+{
+    // Tiles emitted, a wall is counted once for each layer it is in
+    int tiles;
+    int triangles;
+    // One per layer plus one for every time a layer filled raylib's batch and it had to be drawn early
+    int drawCalls;
+} renderCounters;
+
+// Where and how big the tiles are drawn, every window or headless run keeps its own
+typedef struct renderView
+{
+    float tileRadius;
+    Vector2 cameraPos;
+    // Where the passes draw, raylib's batch when it is NULL
+    framebuffer *target;
+    // Cleared by the caller, usually once per frame
+    renderCounters stats;
+} renderView;
+
+void InitRenderView(renderView *view);
+
+Vector2 HexCoordToVector(const renderView *view, hexCoord coord);
+Vector2 HexCoordToCameraVector(const renderView *view, hexCoord coord);
+
+// Collects the tiles of the player's field of view with their screen positions, the set only changes when the player
+// moves or the map changes so only the positions are computed every frame. Returns false and leaves the list empty if
+// it couldn't grow
+bool BuildVisibleTiles(const renderView *view, visibleTiles *list, const visibleSet *set);
+void FreeVisibleTiles(visibleTiles *list);
+
+// The three layers are drawn separately so the player can be drawn between the floor and the walls. Every layer is
+// sent as one batch of triangles so the number of draw calls doesn't grow with the number of tiles
+void DrawFloorTiles(renderView *view, const visibleTiles *list);
+void DrawWallSides(renderView *view, const visibleTiles *list);
+void DrawWallTops(renderView *view, const visibleTiles *list);
+// The player's circle, drawn between the floor and the walls
+void DrawPlayer(const renderView *view, Vector2 position);
+
+#endif
@@ -0,0 +1,21 @@
+#include "rng.h"
+
+// The splitmix64 finalizer, every input bit affects every output bit
+static uint64_t Mix(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+uint64_t RandomBits(uint64_t seed, RANDOMSTREAM stream, uint32_t key, uint32_t counter)
+{
+    uint64_t z = Mix(seed + 0x9E3779B97F4A7C15ull * ((uint64_t)stream + 1));
+    z = Mix(z ^ ((uint64_t)key << 32 | counter));
+    return z;
+}
+
+int RandomRange(uint64_t bits, int min, int max)
+{
+    return min + (int)((bits >> 32) % (uint32_t)(max - min + 1));
+}
@@ -0,0 +1,24 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// Counter based random numbers: every value is a hash of the seed, a stream, a key and a counter, so any value can be
+// computed on any thread in any order and a seed always produces the same world on every machine
+typedef enum RANDOMSTREAM
+{
+    // Keyed by ant index, counter is the draw
+    RANDOMSTREAM_PLACE,
+    // Keyed by ant index, counter is the ant's step
+    RANDOMSTREAM_STEP,
+    // Keyed by chunk coordinates
+    RANDOMSTREAM_CHUNK,
+    // The scripted player of the benchmarks, counter is the move
+    RANDOMSTREAM_PATH
+} RANDOMSTREAM;
+
+uint64_t RandomBits(uint64_t seed, RANDOMSTREAM stream, uint32_t key, uint32_t counter);
+// Maps random bits to a value from min to max, both included
+int RandomRange(uint64_t bits, int min, int max);
+
+#endif
@@ -0,0 +1,225 @@
+#include <string.h>
+
+#include "sim.h"
+
+static const char replayMagic[8] = {'H', 'E', 'X', 'I', 'N', 'P', 'U', 'T'};
+
+bool IsWalkable(hexMap *map, hexCoord coord)
+{
+    TILETYPE tile = GetTile(map, coord);
+    return tile != TILETYPE_WALL && tile != TILETYPE_NONE;
+}
+
+static bool ChunkGenerated(hexMap *map, hexCoord coord)
+{
+    int q, r;
+    CoordToChunk(coord, &q, &r);
+    mapChunk *chunk = GetChunk(map, q, r);
+    return chunk != NULL && chunk->generated;
+}
+
+bool SurroundingsGenerated(hexMap *map, hexCoord coord)
+{
+    if (!ChunkGenerated(map, coord))
+    {
+        return false;
+    }
+    for (int d = 0; d < 6; d++)
+    {
+        if (!ChunkGenerated(map, HexCoordAdd(coord, directionToCoords[d])))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void InitGameState(gameState *state)
+{
+    memset(state, 0, sizeof(gameState));
+    state->moveLerp = 1;
+}
+
+void StepGame(gameState *state, hexMap *map, tickInput input)
+{
+    state->tick++;
+    if (state->moveLerp >= 1)
+    {
+        // The keys are checked in direction order and every one that is down moves the player on from where the
+        // last one left it, the same as the game always did
+        for (int d = 0; d < 6; d++)
+        {
+            if ((input & (1 << d)) == 0)
+            {
+                continue;
+            }
+            hexCoord next = HexCoordAdd(state->player, directionToCoords[d]);
+            if (IsWalkable(map, next))
+            {
+                state->oldPlayer = state->player;
+                state->player = next;
+                state->moveLerp = 0;
+                state->moves++;
+            }
+            else
+            {
+                state->blockedMoves++;
+            }
+        }
+    }
+
+    // The player slides to the new tile in a fifth of a second, starting on the tick of the move
+    if (state->moveLerp < 1)
+    {
+        state->moveLerp += (float)SIM_TICK_SECONDS * 5;
+        state->moveLerp = state->moveLerp < 1 ? state->moveLerp : 1;
+    }
+}
+
+static bool WriteRun(FILE *file, tickInput input, uint64_t run)
+{
+    uint8_t bytes[11];
+    int count = 0;
+    bytes[count++] = input;
+    do
+    {
+        uint8_t byte = run & 0x7f;
+        run >>= 7;
+        bytes[count++] = byte | (run != 0 ? 0x80 : 0);
+    } while (run != 0);
+    return fwrite(bytes, 1, count, file) == (size_t)count;
+}
+
+bool StartRecording(inputRecorder *recorder, const char *path, generatorParams params)
+{
+    *recorder = (inputRecorder){0};
+    recorder->file = fopen(path, "wb");
+    if (recorder->file == NULL)
+    {
+        return false;
+    }
+
+    replayHeader header = {0};
+    memcpy(header.magic, replayMagic, sizeof(header.magic));
+    header.version = REPLAY_VERSION;
+    header.tickRate = SIM_TICK_RATE;
+    header.seed = params.seed;
+    header.mapRadius = params.mapRadius;
+    header.turnChanceDenominator = params.turnChanceDenominator;
+    header.antCount = params.antCount;
+    header.roomRadius = params.roomRadius;
+    if (fwrite(&header, sizeof(header), 1, recorder->file) != 1)
+    {
+        fclose(recorder->file);
+        recorder->file = NULL;
+        return false;
+    }
+    return true;
+}
+
+void RecordInput(inputRecorder *recorder, tickInput input)
+{
+    if (recorder->run > 0 && input != recorder->input)
+    {
+        recorder->failed |= !WriteRun(recorder->file, recorder->input, recorder->run);
+        recorder->run = 0;
+    }
+    recorder->input = input;
+    recorder->run++;
+}
+
+bool StopRecording(inputRecorder *recorder, const gameState *state)
+{
+    bool ok = !recorder->failed && (recorder->run == 0 || WriteRun(recorder->file, recorder->input, recorder->run));
+    uint8_t end = REPLAY_END;
+    replayEnding ending = {(uint64_t)state->tick, state->player.q, state->player.r};
+    ok = ok && fwrite(&end, 1, 1, recorder->file) == 1 && fwrite(&ending, sizeof(ending), 1, recorder->file) == 1;
+    // A failed write can show up on close
+    ok = fclose(recorder->file) == 0 && ok;
+    recorder->file = NULL;
+    return ok;
+}
+
+bool OpenReplay(inputReplay *replay, const char *path)
+{
+    *replay = (inputReplay){0};
+    replay->file = fopen(path, "rb");
+    if (replay->file == NULL)
+    {
+        return false;
+    }
+    if (fread(&replay->header, sizeof(replayHeader), 1, replay->file) != 1 ||
+        memcmp(replay->header.magic, replayMagic, sizeof(replayMagic)) != 0 ||
+        replay->header.version != REPLAY_VERSION ||
+        replay->header.tickRate != SIM_TICK_RATE ||
+        !GeneratorParamsValid(ReplayParams(replay, DefaultGeneratorParams())))
+    {
+        CloseReplay(replay);
+        return false;
+    }
+    return true;
+}
+
+generatorParams ReplayParams(const inputReplay *replay, generatorParams defaults)
+{
+    defaults.seed = replay->header.seed;
+    defaults.mapRadius = replay->header.mapRadius;
+    defaults.turnChanceDenominator = replay->header.turnChanceDenominator;
+    defaults.antCount = replay->header.antCount;
+    defaults.roomRadius = replay->header.roomRadius;
+    return defaults;
+}
+
+bool NextReplayInput(inputReplay *replay, tickInput *input)
+{
+    while (replay->run == 0)
+    {
+        int first = replay->finished ? EOF : fgetc(replay->file);
+        if (first == EOF)
+        {
+            return false;
+        }
+        if (first == REPLAY_END)
+        {
+            replay->finished = fread(&replay->ending, sizeof(replayEnding), 1, replay->file) == 1;
+            return false;
+        }
+
+        uint64_t run = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            int byte = fgetc(replay->file);
+            if (byte == EOF)
+            {
+                return false;
+            }
+            run |= (uint64_t)(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                break;
+            }
+        }
+        replay->input = (tickInput)first;
+        replay->run = run;
+    }
+    replay->run--;
+    *input = replay->input;
+    return true;
+}
+
+bool ReplayMatches(const inputReplay *replay, const gameState *state)
+{
+    return replay->finished &&
+        replay->ending.ticks == (uint64_t)state->tick &&
+        replay->ending.q == state->player.q &&
+        replay->ending.r == state->player.r;
+}
+
+void CloseReplay(inputReplay *replay)
+{
+    if (replay->file != NULL)
+    {
+        fclose(replay->file);
+    }
+    replay->file = NULL;
+}
@@ -0,0 +1,105 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "map.h"
+#include "generator.h"
+
+// The game moves in fixed ticks no matter the frame rate, so the same inputs always move the player the same way
+#define SIM_TICK_RATE 60
+#define SIM_TICK_SECONDS (1.0 / SIM_TICK_RATE)
+// A slow frame runs at most this many ticks, the game slows down instead of falling further behind
+#define SIM_MAX_TICKS_PER_FRAME 8
+
+// The movement keys held during a tick, bit d is set when the key for directionToCoords[d] is down
+typedef uint8_t tickInput;
+
+typedef struct gameState
+{
+    hexCoord player;
+    // The tile the player is sliding from
+    hexCoord oldPlayer;
+    // 1 means the player is at the new position, 0 means the player is at the old position
+    float moveLerp;
+    long long tick;
+    // Tiles walked and ticks a key was held against a wall or the edge of the generated world
+    long long moves;
+    long long blockedMoves;
+} gameState;
+
+// A tile the player can stand on
+bool IsWalkable(hexMap *map, hexCoord coord);
+// True when the chunks of the tile and of every tile next to it are generated. A tick that waits for this moves the
+// same way no matter when the chunks arrive
+bool SurroundingsGenerated(hexMap *map, hexCoord coord);
+void InitGameState(gameState *state);
+// Advances the game by one tick, a new move can only start once the player has arrived at the last tile
+void StepGame(gameState *state, hexMap *map, tickInput input);
+
+#define REPLAY_VERSION 1
+
+// An input file is this header followed by runs of the same input, each a byte with the input and the number of ticks
+// it was held as a LEB128 varint. A byte of REPLAY_END ends the runs and is followed by replayEnding
+typedef struct replayHeader
+{
+    // "HEXINPUT"
+    char magic[8];
+    uint32_t version;
+    uint32_t tickRate;
+    // The world the inputs were recorded in
+    uint64_t seed;
+    int32_t mapRadius;
+    int32_t turnChanceDenominator;
+    int32_t antCount;
+    int32_t roomRadius;
+} replayHeader;
+
+#define REPLAY_END 0xff
+
+// Where the recording stopped so a replay can check that it ended up in the same place
+typedef struct replayEnding
+{
+    uint64_t ticks;
+    int32_t q;
+    int32_t r;
+} replayEnding;
+
+typedef struct inputRecorder
+{
+    FILE *file;
+    tickInput input;
+    // Ticks the current input has been held and not written yet
+    uint64_t run;
+    bool failed;
+} inputRecorder;
+
+typedef struct inputReplay
+{
+    FILE *file;
+    replayHeader header;
+    tickInput input;
+    uint64_t run;
+    // Filled in once the last run has been read
+    replayEnding ending;
+    bool finished;
+} inputReplay;
+
+bool StartRecording(inputRecorder *recorder, const char *path, generatorParams params);
+void RecordInput(inputRecorder *recorder, tickInput input);
+// Writes the last run and where the player ended up and closes the file
+bool StopRecording(inputRecorder *recorder, const gameState *state);
+
+// Fails if the file isn't a recording or the params in it couldn't generate a map
+bool OpenReplay(inputReplay *replay, const char *path);
+// The params the recording was made with, everything else comes from defaults
+generatorParams ReplayParams(const inputReplay *replay, generatorParams defaults);
+// The input of the next tick, returns false when the recording is over or the file is broken
+bool NextReplayInput(inputReplay *replay, tickInput *input);
+// True if the recording ended and the state is where the recording stopped
+bool ReplayMatches(const inputReplay *replay, const gameState *state);
+void CloseReplay(inputReplay *replay);
+
+#endif
@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "snapshot.h"
+
+_Static_assert(sizeof(mapChunk) == 24 + CHUNK_SIZE * CHUNK_SIZE, "mapChunk must have the layout snapshots are written with");
+
+static const char snapshotMagic[8] = {'H', 'E', 'X', 'D', 'U', 'N', 'G', 'N'};
+// The chunks start on a page boundary
+static const uint64_t payloadOffset = 4096;
+
+static int CompareChunks(const void *a, const void *b)
+{
+    const mapChunk *x = *(const mapChunk **)a;
+    const mapChunk *y = *(const mapChunk **)b;
+    if (x->q != y->q)
+    {
+        return x->q < y->q ? -1 : 1;
+    }
+    return x->r < y->r ? -1 : x->r > y->r;
+}
+
+bool SaveSnapshot(const hexMap *map, const char *path, generatorParams params)
+{
+    int chunkCount = MapChunkCount(map);
+    mapChunk **chunks = malloc(sizeof(mapChunk *) * (chunkCount + 1));
+    if (chunks == NULL)
+    {
+        return false;
+    }
+    CollectChunks(map, chunks);
+    // Sorted so the same world always gives the same file
+    qsort(chunks, chunkCount, sizeof(mapChunk *), CompareChunks);
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        free(chunks);
+        return false;
+    }
+
+    snapshotHeader header = {
+        .version = SNAPSHOT_VERSION,
+        .chunkSize = CHUNK_SIZE,
+        .chunkBytes = sizeof(mapChunk),
+        .chunkCount = chunkCount,
+        .payloadOffset = payloadOffset,
+        .seed = params.seed,
+        .mapRadius = params.mapRadius,
+        .turnChanceDenominator = params.turnChanceDenominator,
+        .antCount = params.antCount,
+        .roomRadius = params.roomRadius};
+    memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+
+    static const char zeros[4096] = {0};
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+        fwrite(zeros, payloadOffset - sizeof(header), 1, file) == 1;
+    for (int i = 0; ok && i < chunkCount; i++)
+    {
+        mapChunk chunk = *chunks[i];
+        chunk.owned = false;
+        chunk.trails = NULL;
+        ok = fwrite(&chunk, sizeof(mapChunk), 1, file) == 1;
+    }
+    free(chunks);
+    return fclose(file) == 0 && ok;
+}
+
+static generatorParams HeaderParams(const snapshotHeader *header, generatorParams defaults)
+{
+    defaults.seed = header->seed;
+    defaults.mapRadius = header->mapRadius;
+    defaults.turnChanceDenominator = header->turnChanceDenominator;
+    defaults.antCount = header->antCount;
+    defaults.roomRadius = header->roomRadius;
+    return defaults;
+}
+
+bool LoadSnapshot(hexMap *map, const char *path, snapshot *out)
+{
+    *out = (snapshot){0};
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < payloadOffset)
+    {
+        close(fd);
+        return false;
+    }
+
+    // Private so the game can still change tiles, the pages are only copied when that happens
+    void *data = mmap(NULL, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const snapshotHeader *header = data;
+    if (memcmp(header->magic, snapshotMagic, sizeof(header->magic)) != 0 ||
+        header->version != SNAPSHOT_VERSION ||
+        header->chunkSize != CHUNK_SIZE ||
+        header->chunkBytes != sizeof(mapChunk) ||
+        header->payloadOffset < sizeof(snapshotHeader) ||
+        header->payloadOffset % _Alignof(mapChunk) != 0 ||
+        header->payloadOffset > (uint64_t)info.st_size ||
+        header->chunkCount > ((uint64_t)info.st_size - header->payloadOffset) / sizeof(mapChunk) ||
+        !GeneratorParamsValid(HeaderParams(header, DefaultGeneratorParams())))
+    {
+        munmap(data, info.st_size);
+        return false;
+    }
+
+    mapChunk *chunks = (mapChunk *)((char *)data + header->payloadOffset);
+    for (uint32_t i = 0; i < header->chunkCount; i++)
+    {
+        // Snapshots are written with neither set, a file that has them would have the map free or follow a pointer
+        // into nowhere
+        if (chunks[i].owned || chunks[i].trails != NULL)
+        {
+            ClearMap(map);
+            munmap(data, info.st_size);
+            return false;
+        }
+        if (!InsertChunk(map, &chunks[i]))
+        {
+            // Some chunks may already point into the mapping
+            ClearMap(map);
+            munmap(data, info.st_size);
+            return false;
+        }
+    }
+
+    *out = (snapshot){data, info.st_size, header};
+    return true;
+}
+
+generatorParams SnapshotParams(const snapshot *loaded, generatorParams defaults)
+{
+    return HeaderParams(loaded->header, defaults);
+}
+
+void CloseSnapshot(snapshot *loaded)
+{
+    if (loaded->data != NULL)
+    {
+        munmap(loaded->data, loaded->size);
+    }
+    *loaded = (snapshot){0};
+}
@@ -0,0 +1,51 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "generator.h"
+
+#define SNAPSHOT_VERSION 2
+
+// A snapshot file is this header, padding up to payloadOffset and then every chunk of the map exactly as mapChunk
+// is laid out in memory, so loading only has to map the file and point the map at the chunks
+typedef struct snapshotHeader
+{
+    // "HEXDUNGN"
+    char magic[8];
+    // Also tells if the file was written with a different byte order
+    uint32_t version;
+    uint32_t chunkSize;
+    // sizeof(mapChunk), files written with a different chunk layout are rejected
+    uint32_t chunkBytes;
+    uint32_t chunkCount;
+    uint64_t payloadOffset;
+    // The generator parameters the world was made with
+    uint64_t seed;
+    int32_t mapRadius;
+    int32_t turnChanceDenominator;
+    int32_t antCount;
+    int32_t roomRadius;
+} snapshotHeader;
+
+typedef struct snapshot
+{
+    void *data;
+    size_t size;
+    const snapshotHeader *header;
+} snapshot;
+
+// Writes every chunk in the map to the file
+bool SaveSnapshot(const hexMap *map, const char *path, generatorParams params);
+// Maps the file and adds its chunks to the map. The chunks live in the mapping, writing to them only changes this
+// process' copy, so CloseSnapshot must only be called after the map has been cleared. If it fails after some chunks
+// were added the map is cleared. Files whose params couldn't generate a map are rejected
+bool LoadSnapshot(hexMap *map, const char *path, snapshot *out);
+// The params the world was saved with, new chunks have to be generated with them to fit the saved ones. Everything
+// else comes from defaults
+generatorParams SnapshotParams(const snapshot *loaded, generatorParams defaults);
+void CloseSnapshot(snapshot *loaded);
+
+#endif
@@ -0,0 +1,258 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "stream.h"
+#include "hexquery.h"
+
+static int ChunkDistance(chunkRequest a, chunkRequest b)
+{
+    return HexDistance((hexCoord){a.q, a.r, -a.q - a.r}, (hexCoord){b.q, b.r, -b.q - b.r});
+}
+
+static bool ContainsRequest(const chunkRequest *requests, int count, int q, int r)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (requests[i].q == q && requests[i].r == r)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Keeps a chunk that couldn't be generated from being requested again every frame, if the list can't grow it only
+// gets logged
+static void RecordFailedChunk(chunkStreamer *streamer, chunkRequest request)
+{
+    fprintf(stderr, "failed to generate chunk %d, %d\n", request.q, request.r);
+    if (streamer->failedCount == streamer->failedCapacity)
+    {
+        int capacity = streamer->failedCapacity == 0 ? 16 : streamer->failedCapacity * 2;
+        chunkRequest *failed = realloc(streamer->failed, sizeof(chunkRequest) * capacity);
+        if (failed == NULL)
+        {
+            return;
+        }
+        streamer->failed = failed;
+        streamer->failedCapacity = capacity;
+    }
+    streamer->failed[streamer->failedCount++] = request;
+}
+
+static void *RunChunkStreamer(void *data)
+{
+    chunkStreamer *streamer = data;
+    pthread_mutex_lock(&streamer->lock);
+    while (!streamer->quit)
+    {
+        if (streamer->requestCount == 0)
+        {
+            pthread_cond_wait(&streamer->wake, &streamer->lock);
+            continue;
+        }
+
+        // Generate around the player first so they can move while the rest finishes
+        int closest = 0;
+        for (int i = 1; i < streamer->requestCount; i++)
+        {
+            if (ChunkDistance(streamer->requests[i], streamer->focus) <
+                ChunkDistance(streamer->requests[closest], streamer->focus))
+            {
+                closest = i;
+            }
+        }
+        streamer->working = streamer->requests[closest];
+        streamer->requests[closest] = streamer->requests[--streamer->requestCount];
+        streamer->isWorking = true;
+        generatorParams params = streamer->params;
+        int revision = streamer->paramsRevision;
+        pthread_mutex_unlock(&streamer->lock);
+
+        mapChunk *chunk = BuildChunkInArena(&streamer->scratch, streamer->working.q, streamer->working.r, params);
+
+        pthread_mutex_lock(&streamer->lock);
+        streamer->isWorking = false;
+        if (revision != streamer->paramsRevision)
+        {
+            FreeChunk(chunk);
+            continue;
+        }
+        if (chunk == NULL)
+        {
+            RecordFailedChunk(streamer, streamer->working);
+            continue;
+        }
+        if (streamer->finishedCount == streamer->finishedCapacity)
+        {
+            int capacity = streamer->finishedCapacity == 0 ? 16 : streamer->finishedCapacity * 2;
+            mapChunk **finished = realloc(streamer->finished, sizeof(mapChunk *) * capacity);
+            if (finished == NULL)
+            {
+                FreeChunk(chunk);
+                continue;
+            }
+            streamer->finished = finished;
+            streamer->finishedCapacity = capacity;
+        }
+        streamer->finished[streamer->finishedCount++] = chunk;
+    }
+    pthread_mutex_unlock(&streamer->lock);
+    return NULL;
+}
+
+bool StartChunkStreamer(chunkStreamer *streamer, hexMap *map, generatorParams params)
+{
+    *streamer = (chunkStreamer){0};
+    streamer->map = map;
+    streamer->params = params;
+    if (pthread_mutex_init(&streamer->lock, NULL) != 0)
+    {
+        return false;
+    }
+    if (pthread_cond_init(&streamer->wake, NULL) != 0)
+    {
+        pthread_mutex_destroy(&streamer->lock);
+        return false;
+    }
+    if (pthread_create(&streamer->thread, NULL, RunChunkStreamer, streamer) != 0)
+    {
+        pthread_cond_destroy(&streamer->wake);
+        pthread_mutex_destroy(&streamer->lock);
+        return false;
+    }
+    return true;
+}
+
+static bool IsRequested(chunkStreamer *streamer, int q, int r)
+{
+    if (streamer->isWorking && streamer->working.q == q && streamer->working.r == r)
+    {
+        return true;
+    }
+    return ContainsRequest(streamer->requests, streamer->requestCount, q, r);
+}
+
+int StreamChunksAround(chunkStreamer *streamer, hexCoord coord, int distance)
+{
+    int q, r;
+    CoordToChunk(coord, &q, &r);
+
+    pthread_mutex_lock(&streamer->lock);
+    streamer->focus = (chunkRequest){q, r};
+
+    // Hand the finished chunks to the map, they are complete so they show up all at once
+    int added = 0;
+    for (int i = 0; i < streamer->finishedCount; i++)
+    {
+        mapChunk *chunk = streamer->finished[i];
+        if (chunk->trails != NULL && chunk->trails->roomRadius != streamer->params.roomRadius)
+        {
+            RecarveRooms(chunk, streamer->params.roomRadius);
+        }
+        if (InsertChunk(streamer->map, chunk))
+        {
+            added++;
+        }
+        else
+        {
+            FreeChunk(chunk);
+        }
+    }
+    streamer->finishedCount = 0;
+
+    bool requested = false;
+    for (int i = q - distance; i <= q + distance; i++)
+    {
+        for (int j = r - distance; j <= r + distance; j++)
+        {
+            mapChunk *chunk = GetChunk(streamer->map, i, j);
+            if ((chunk != NULL && chunk->generated) || IsRequested(streamer, i, j) ||
+                ContainsRequest(streamer->failed, streamer->failedCount, i, j))
+            {
+                continue;
+            }
+            if (streamer->requestCount == streamer->requestCapacity)
+            {
+                int capacity = streamer->requestCapacity == 0 ? 16 : streamer->requestCapacity * 2;
+                chunkRequest *requests = realloc(streamer->requests, sizeof(chunkRequest) * capacity);
+                if (requests == NULL)
+                {
+                    break;
+                }
+                streamer->requests = requests;
+                streamer->requestCapacity = capacity;
+            }
+            streamer->requests[streamer->requestCount++] = (chunkRequest){i, j};
+            requested = true;
+        }
+    }
+    if (requested)
+    {
+        pthread_cond_signal(&streamer->wake);
+    }
+    pthread_mutex_unlock(&streamer->lock);
+    return added;
+}
+
+void SetChunkStreamerParams(chunkStreamer *streamer, generatorParams params)
+{
+    pthread_mutex_lock(&streamer->lock);
+    generatorParams old = streamer->params;
+    bool recarve = params.keepTrails && old.keepTrails &&
+        params.mapRadius == old.mapRadius &&
+        params.turnChanceDenominator == old.turnChanceDenominator &&
+        params.antCount == old.antCount &&
+        params.seed == old.seed;
+    streamer->params = params;
+    if (!recarve)
+    {
+        // The chunk being generated is thrown away when it finishes, the rest right away
+        streamer->paramsRevision++;
+        streamer->requestCount = 0;
+        // The new params may generate them
+        streamer->failedCount = 0;
+        for (int i = 0; i < streamer->finishedCount; i++)
+        {
+            FreeChunk(streamer->finished[i]);
+        }
+        streamer->finishedCount = 0;
+    }
+    pthread_mutex_unlock(&streamer->lock);
+}
+
+bool ChunkStreamerFailed(chunkStreamer *streamer, int q, int r)
+{
+    pthread_mutex_lock(&streamer->lock);
+    bool failed = ContainsRequest(streamer->failed, streamer->failedCount, q, r);
+    pthread_mutex_unlock(&streamer->lock);
+    return failed;
+}
+
+bool ChunkStreamerIdle(chunkStreamer *streamer)
+{
+    pthread_mutex_lock(&streamer->lock);
+    bool idle = streamer->requestCount == 0 && !streamer->isWorking && streamer->finishedCount == 0;
+    pthread_mutex_unlock(&streamer->lock);
+    return idle;
+}
+
+void StopChunkStreamer(chunkStreamer *streamer)
+{
+    pthread_mutex_lock(&streamer->lock);
+    streamer->quit = true;
+    pthread_cond_signal(&streamer->wake);
+    pthread_mutex_unlock(&streamer->lock);
+    pthread_join(streamer->thread, NULL);
+
+    for (int i = 0; i < streamer->finishedCount; i++)
+    {
+        FreeChunk(streamer->finished[i]);
+    }
+    free(streamer->finished);
+    free(streamer->requests);
+    free(streamer->failed);
+    FreeArena(&streamer->scratch);
+    pthread_cond_destroy(&streamer->wake);
+    pthread_mutex_destroy(&streamer->lock);
+}
@@ -0,0 +1,61 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "map.h"
+#include "generator.h"
+
+typedef struct chunkRequest
+{
+    int q;
+    int r;
+} chunkRequest;
+
+// Generates chunks on a worker thread so the game never waits for the generator.
+// Only the main thread touches the map, finished chunks are added to it in StreamChunksAround
+typedef struct chunkStreamer
+{
+    hexMap *map;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    // The worker's generator memory, kept from chunk to chunk
+    arena scratch;
+    generatorParams params;
+    // Changes whenever chunks built with the previous params have to be thrown away
+    int paramsRevision;
+    // The chunk the player is in, requests closest to it are generated first
+    chunkRequest focus;
+    chunkRequest *requests;
+    int requestCount;
+    int requestCapacity;
+    // The chunk being generated right now
+    chunkRequest working;
+    bool isWorking;
+    mapChunk **finished;
+    int finishedCount;
+    int finishedCapacity;
+    // Chunks the generator couldn't build, they aren't requested again until the params change
+    chunkRequest *failed;
+    int failedCount;
+    int failedCapacity;
+    bool quit;
+} chunkStreamer;
+
+bool StartChunkStreamer(chunkStreamer *streamer, hexMap *map, generatorParams params);
+// Adds the chunks that have finished to the map and requests the missing chunks within distance chunks of coord,
+// returns the number of chunks added to the map
+int StreamChunksAround(chunkStreamer *streamer, hexCoord coord, int distance);
+// Changes the parameters chunks are generated with. Chunks that are waiting or being generated are thrown away and
+// requested again, unless only roomRadius changed and params.keepTrails is set, then their rooms are carved again
+// when they are added to the map. The chunks already in the map are left to the caller
+void SetChunkStreamerParams(chunkStreamer *streamer, generatorParams params);
+// True if the chunk couldn't be generated with the current params
+bool ChunkStreamerFailed(chunkStreamer *streamer, int q, int r);
+// True when no chunks are waiting to be generated or added to the map
+bool ChunkStreamerIdle(chunkStreamer *streamer);
+void StopChunkStreamer(chunkStreamer *streamer);
+
+#endif